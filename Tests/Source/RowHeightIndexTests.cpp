@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "RowHeightIndex.h"
+
+namespace jux
+{
+/*  Returns a BlockFiller that reads the heights of the rows from firstRow onwards from a vector. */
+static auto filler (const std::vector<int>& source, const int firstRow)
+{
+    return [&source, firstRow] (juce::Range<int> rows, int* dest)
+    {
+        for (auto row = rows.getStart(); row < rows.getEnd(); ++row)
+            *dest++ = source[(size_t) (row - firstRow)];
+    };
+}
+
+//==============================================================================
+/*  Checks RowHeightIndex against a plain vector of heights, in both of its storage modes. */
+class RowHeightIndexTests : public juce::UnitTest
+{
+public:
+    RowHeightIndexTests() : juce::UnitTest ("RowHeightIndex", "JUX") {}
+
+    void runTest() override
+    {
+        beginTest ("Uniform heights");
+        {
+            RowHeightIndex index;
+            index.buildUniform (1000, 20);
+            expect (index.isCompressed());
+            expectMatches (index, std::vector<int> (1000, 20));
+
+            index.buildUniform (0, 20);
+            expectMatches (index, {});
+        }
+
+        beginTest ("Build, replacing heights that aren't positive");
+        {
+            const std::vector<int> source { 10, 0, 30, -5, 30, 30 };
+            RowHeightIndex index;
+            index.build ((int) source.size(), 7, filler (source, 0));
+            expectMatches (index, { 10, 7, 30, 7, 30, 30 });
+        }
+
+        beginTest ("Single changes");
+        {
+            std::vector<int> expected (100, 20);
+            RowHeightIndex index;
+            index.buildUniform (100, 20);
+
+            index.setHeight (50, 40);
+            expected[50] = 40;
+            expectMatches (index, expected);
+
+            index.removeFirstRows (10);
+            expected.erase (expected.begin(), expected.begin() + 10);
+            expectMatches (index, expected);
+
+            index.removeRows (30, 20);
+            expected.erase (expected.begin() + 30, expected.begin() + 50);
+            expectMatches (index, expected);
+
+            const std::vector<int> inserted { 5, 6, 7 };
+            index.insertRows (10, 3, 20, filler (inserted, 10));
+            expected.insert (expected.begin() + 10, inserted.begin(), inserted.end());
+            expectMatches (index, expected);
+
+            index.moveRows (10, 3, 60);
+            moveRows (expected, 10, 3, 60);
+            expectMatches (index, expected);
+
+            index.appendRows (3, 20, filler (inserted, index.size()));
+            expected.insert (expected.end(), inserted.begin(), inserted.end());
+            expectMatches (index, expected);
+        }
+
+        beginTest ("Switching to individual heights");
+        {
+            std::vector<int> expected (2000, 20);
+            RowHeightIndex index;
+            index.buildUniform (2000, 20);
+
+            for (auto row = 0; row < 2000; row += 2)
+            {
+                index.setHeight (row, 10 + row % 7);
+                expected[(size_t) row] = 10 + row % 7;
+            }
+
+            expect (! index.isCompressed());
+            expectMatches (index, expected);
+        }
+
+        for (auto pattern = 0; pattern < numPatterns; ++pattern)
+        {
+            beginTest ("Random changes, pattern " + juce::String (pattern));
+            runRandomChanges (pattern);
+        }
+    }
+
+private:
+    static constexpr int numPatterns = 3;
+
+    static void moveRows (std::vector<int>& v, const int startRow, const int numRows, const int newStartRow)
+    {
+        const auto begin = v.begin();
+
+        if (newStartRow < startRow)
+            std::rotate (begin + newStartRow, begin + startRow, begin + startRow + numRows);
+        else
+            std::rotate (begin + startRow, begin + startRow + numRows, begin + newStartRow + numRows);
+    }
+
+    /*  Pattern 0 is a single height, 1 is long runs of a few heights, and 2 is a different
+        height for most rows, some of which aren't positive.
+    */
+    static std::vector<int> makeHeights (juce::Random& random, const int pattern, const int numRows)
+    {
+        std::vector<int> result;
+        result.reserve ((size_t) numRows);
+
+        while ((int) result.size() < numRows)
+        {
+            const auto runLength = pattern == 0 ? numRows : pattern == 1 ? 1 + random.nextInt (300) : 1;
+            const auto height = pattern == 0 ? 20 : pattern == 1 ? 10 * (1 + random.nextInt (3)) : random.nextInt (41) - 5;
+            result.insert (result.end(), (size_t) juce::jmin (runLength, numRows - (int) result.size()), height);
+        }
+
+        return result;
+    }
+
+    static std::vector<int> withDefaults (std::vector<int> heights, const int defaultHeight)
+    {
+        for (auto& h : heights)
+            h = h > 0 ? h : defaultHeight;
+
+        return heights;
+    }
+
+    void runRandomChanges (const int pattern)
+    {
+        constexpr auto defaultHeight = 15;
+        juce::Random random (0x4a5558 + pattern);
+
+        auto expected = withDefaults (makeHeights (random, pattern, 5000), defaultHeight);
+        RowHeightIndex index;
+        index.build ((int) expected.size(), defaultHeight, filler (expected, 0));
+        expectMatches (index, expected);
+
+        for (auto step = 0; step < 300; ++step)
+        {
+            const auto size = (int) expected.size();
+
+            switch (random.nextInt (6))
+            {
+                case 0:
+                {
+                    const auto startRow = random.nextInt (size + 1);
+                    const auto newHeights = makeHeights (random, pattern, random.nextInt (500));
+                    index.insertRows (startRow, (int) newHeights.size(), defaultHeight, filler (newHeights, startRow));
+
+                    const auto replaced = withDefaults (newHeights, defaultHeight);
+                    expected.insert (expected.begin() + startRow, replaced.begin(), replaced.end());
+                    break;
+                }
+
+                case 1:
+                {
+                    const auto newHeights = makeHeights (random, pattern, random.nextInt (500));
+                    index.appendRows ((int) newHeights.size(), defaultHeight, filler (newHeights, size));
+
+                    const auto replaced = withDefaults (newHeights, defaultHeight);
+                    expected.insert (expected.end(), replaced.begin(), replaced.end());
+                    break;
+                }
+
+                case 2:
+                {
+                    const auto startRow = random.nextInt (size + 1);
+                    const auto numRows = random.nextInt (juce::jmin (500, size - startRow) + 1);
+                    index.removeRows (startRow, numRows);
+                    expected.erase (expected.begin() + startRow, expected.begin() + startRow + numRows);
+                    break;
+                }
+
+                case 3:
+                {
+                    const auto numRows = random.nextInt (juce::jmin (500, size) + 1);
+                    index.removeFirstRows (numRows);
+                    expected.erase (expected.begin(), expected.begin() + numRows);
+                    break;
+                }
+
+                case 4:
+                {
+                    const auto startRow = random.nextInt (size + 1);
+                    const auto numRows = random.nextInt (size - startRow + 1);
+                    const auto newStartRow = random.nextInt (size - numRows + 1);
+                    index.moveRows (startRow, numRows, newStartRow);
+                    moveRows (expected, startRow, numRows, newStartRow);
+                    break;
+                }
+
+                default:
+                {
+                    if (size == 0)
+                        break;
+
+                    const auto row = random.nextInt (size);
+                    const auto height = pattern == 2 ? 1 + random.nextInt (40) : 10 * (1 + random.nextInt (3));
+                    index.setHeight (row, height);
+                    expected[(size_t) row] = height;
+                    break;
+                }
+            }
+
+            // the full check is O(N log N), so it only runs every few steps
+            if (step % 10 == 0)
+                expectMatches (index, expected);
+            else
+                expectEquals (index.getTotalHeight(), sum (expected));
+        }
+
+        expectMatches (index, expected);
+    }
+
+    static juce::int64 sum (const std::vector<int>& heights)
+    {
+        return std::accumulate (heights.begin(), heights.end(), (juce::int64) 0);
+    }
+
+    void expectMatches (const RowHeightIndex& index, const std::vector<int>& expected)
+    {
+        const auto size = (int) expected.size();
+        expectEquals (index.size(), size);
+        expectEquals (index.getTotalHeight(), sum (expected));
+
+        if (index.size() != size)
+            return;
+
+        juce::int64 y = 0;
+        auto numMismatches = 0;
+
+        for (auto row = 0; row < size; ++row)
+        {
+            const auto height = expected[(size_t) row];
+
+            if (index.getHeight (row) != height || index.getRowY (row) != y
+                || index.getRowContaining (y) != row || index.getRowContaining (y + height - 1) != row)
+                ++numMismatches;
+
+            y += height;
+        }
+
+        expectEquals (numMismatches, 0);
+        expectEquals (index.getRowY (size), y);
+        expectEquals (index.getRowContaining (-1), -1);
+        expectEquals (index.getRowContaining (y), size);
+    }
+};
+
+static RowHeightIndexTests rowHeightIndexTests;
+
+} // namespace jux
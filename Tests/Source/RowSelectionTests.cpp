@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "RowSelection.h"
+
+namespace jux
+{
+//==============================================================================
+/*  Checks RowSelection against a plain vector of flags, one per row of a list. */
+class RowSelectionTests : public juce::UnitTest
+{
+public:
+    RowSelectionTests() : juce::UnitTest ("RowSelection", "JUX") {}
+
+    void runTest() override
+    {
+        beginTest ("Adding and removing ranges");
+        {
+            RowSelection selection;
+            std::vector<bool> expected (50, false);
+
+            addRange (selection, expected, { 5, 10 });
+            addRange (selection, expected, { 10, 15 });
+            expectEquals (selection.getNumRanges(), 1);
+
+            addRange (selection, expected, { 20, 25 });
+            removeRange (selection, expected, { 7, 22 });
+            expectEquals (selection.getNumRanges(), 2);
+            expectMatches (selection, expected);
+
+            selection.clear();
+            std::fill (expected.begin(), expected.end(), false);
+            expectMatches (selection, expected);
+        }
+
+        beginTest ("Inserting, removing and moving rows");
+        {
+            RowSelection selection;
+            std::vector<bool> expected (30, false);
+            addRange (selection, expected, { 5, 15 });
+
+            selection.insertRows (10, 3);
+            expected.insert (expected.begin() + 10, 3, false);
+            expectMatches (selection, expected);
+
+            selection.removeRows (12, 5);
+            expected.erase (expected.begin() + 12, expected.begin() + 17);
+            expectMatches (selection, expected);
+
+            selection.moveRows (4, 4, 15);
+            moveRows (expected, 4, 4, 15);
+            expectMatches (selection, expected);
+        }
+
+        beginTest ("Random changes");
+        {
+            juce::Random random (0x4a5558);
+            RowSelection selection;
+            std::vector<bool> expected (200, false);
+
+            for (auto step = 0; step < 2000; ++step)
+            {
+                const auto size = (int) expected.size();
+                const auto start = random.nextInt (size + 1);
+                const auto length = random.nextInt (juce::jmin (40, size - start) + 1);
+
+                switch (random.nextInt (5))
+                {
+                    case 0:  addRange (selection, expected, { start, start + length }); break;
+                    case 1:  removeRange (selection, expected, { start, start + length }); break;
+
+                    case 2:
+                        selection.insertRows (start, length);
+                        expected.insert (expected.begin() + start, (size_t) length, false);
+                        break;
+
+                    case 3:
+                        selection.removeRows (start, length);
+                        expected.erase (expected.begin() + start, expected.begin() + start + length);
+                        break;
+
+                    default:
+                    {
+                        const auto newStart = random.nextInt (size - length + 1);
+                        selection.moveRows (start, length, newStart);
+                        moveRows (expected, start, length, newStart);
+                        break;
+                    }
+                }
+
+                // keeps the list from growing or shrinking away
+                if (expected.size() > 300)
+                {
+                    selection.removeRows (200, (int) expected.size() - 200);
+                    expected.resize (200);
+                }
+                else if (expected.size() < 100)
+                {
+                    expected.resize (expected.size() + 100, false);
+                }
+
+                expectMatches (selection, expected);
+            }
+        }
+    }
+
+private:
+    static void addRange (RowSelection& selection, std::vector<bool>& expected, juce::Range<int> rows)
+    {
+        selection.addRange (rows);
+        std::fill (expected.begin() + rows.getStart(), expected.begin() + rows.getEnd(), true);
+    }
+
+    static void removeRange (RowSelection& selection, std::vector<bool>& expected, juce::Range<int> rows)
+    {
+        selection.removeRange (rows);
+        std::fill (expected.begin() + rows.getStart(), expected.begin() + rows.getEnd(), false);
+    }
+
+    static void moveRows (std::vector<bool>& v, const int startRow, const int numRows, const int newStartRow)
+    {
+        const auto begin = v.begin();
+
+        if (newStartRow < startRow)
+            std::rotate (begin + newStartRow, begin + startRow, begin + startRow + numRows);
+        else
+            std::rotate (begin + startRow, begin + startRow + numRows, begin + newStartRow + numRows);
+    }
+
+    void expectMatches (const RowSelection& selection, const std::vector<bool>& expected)
+    {
+        const auto size = (int) expected.size();
+        std::vector<int> rows;
+        auto numRanges = 0;
+
+        for (auto row = 0; row < size; ++row)
+        {
+            if (expected[(size_t) row])
+            {
+                if (row == 0 || ! expected[(size_t) row - 1])
+                    ++numRanges;
+
+                rows.push_back (row);
+            }
+        }
+
+        expectEquals (selection.size(), (int) rows.size());
+        expectEquals (selection.getNumRanges(), numRanges);
+        expect (selection.getTotalRange() == (rows.empty() ? juce::Range<int>() : juce::Range<int> (rows.front(), rows.back() + 1)));
+
+        auto numMismatches = 0;
+
+        for (auto row = 0; row < size; ++row)
+        {
+            const auto next = std::lower_bound (rows.begin(), rows.end(), row);
+
+            if (selection.contains (row) != expected[(size_t) row]
+                || selection.getNextRow (row) != (next != rows.end() ? *next : -1))
+                ++numMismatches;
+        }
+
+        for (size_t i = 0; i < rows.size(); ++i)
+            if (selection.getRow ((int) i) != rows[i])
+                ++numMismatches;
+
+        expectEquals (numMismatches, 0);
+        expectEquals (selection.getRow ((int) rows.size()), -1);
+
+        // a range in the middle of the list, which may cut through the selected ranges
+        const juce::Range<int> window (size / 4, size / 2);
+        const auto numInWindow = (int) std::count (expected.begin() + window.getStart(), expected.begin() + window.getEnd(), true);
+        expectEquals (selection.countInRange (window), numInWindow);
+        expect (selection.overlapsRange (window) == (numInWindow > 0));
+        expectEquals (selection.getRowsIn (window).size(), numInWindow);
+
+        const auto withoutWindow = selection.withoutRowsIn (selection.getRowsIn (window));
+        expectEquals (withoutWindow.size(), selection.size() - numInWindow);
+        expect (! withoutWindow.overlapsRange (window));
+
+        // the conversions to and from juce::SparseSet keep the same rows
+        const auto sparseSet = selection.toSparseSet();
+        expectEquals (sparseSet.size(), (int) rows.size());
+        expectEquals (sparseSet.getNumRanges(), numRanges);
+        expect (RowSelection (sparseSet) == selection);
+    }
+};
+
+static RowSelectionTests rowSelectionTests;
+
+} // namespace jux
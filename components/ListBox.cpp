@@ -94,12 +94,18 @@ class ComponentWithListRowMouseBehaviours : public juce::Component
 
 public:
     void updateRowAndSelection (const int newRow, const bool nowSelected)
+    {
+        if (setRowAndSelection (newRow, nowSelected))
+            repaint();
+    }
+
+    /*  Like updateRowAndSelection(), but without repainting. Returns true if anything changed. */
+    bool setRowAndSelection (const int newRow, const bool nowSelected)
     {
         const auto rowChanged       = std::exchange (row,      newRow)      != newRow;
         const auto selectionChanged = std::exchange (selected, nowSelected) != nowSelected;
 
-        if (rowChanged || selectionChanged)
-            repaint();
+        return rowChanged || selectionChanged;
     }
 
     void mouseDown (const juce::MouseEvent& e) override
@@ -107,10 +113,23 @@ public:
         isDragging = false;
         isDraggingToScroll = false;
         selectRowOnMouseUp = false;
+        isMouseTakenByModel = false;
 
         if (! asBase().isEnabled())
             return;
 
+        if (auto* m = getOwner().getModel())
+        {
+            const auto area = asBase().getRowArea();
+
+            if (m->rowMouseDown (row, area.getWidth(), area.getHeight(), getEventRelativeToRow (e, area)))
+            {
+                isMouseTakenByModel = true;
+                getOwner().repaintRow (row);
+                return;
+            }
+        }
+
         const auto select = getOwner().getRowSelectedOnMouseDown()
                             && ! selected
                             && ! viewportWouldScrollOnEvent (getOwner().getViewport(), e.source) ;
@@ -122,12 +141,36 @@ public:
 
     void mouseUp (const juce::MouseEvent& e) override
     {
+        if (std::exchange (isMouseTakenByModel, false))
+        {
+            if (auto* m = getOwner().getModel())
+            {
+                const auto area = asBase().getRowArea();
+                m->rowMouseUp (row, area.getWidth(), area.getHeight(), getEventRelativeToRow (e, area));
+                getOwner().repaintRow (row);
+            }
+
+            return;
+        }
+
         if (asBase().isEnabled() && selectRowOnMouseUp && ! (isDragging || isDraggingToScroll))
             asBase().performSelection (e, true);
     }
 
     void mouseDrag (const juce::MouseEvent& e) override
     {
+        if (isMouseTakenByModel)
+        {
+            if (auto* m = getOwner().getModel())
+            {
+                const auto area = asBase().getRowArea();
+                m->rowMouseDrag (row, area.getWidth(), area.getHeight(), getEventRelativeToRow (e, area));
+                getOwner().repaintRow (row);
+            }
+
+            return;
+        }
+
         if (auto* m = getOwner().getModel())
         {
             if (asBase().isEnabled() && e.mouseWasDraggedSinceMouseDown() && ! isDragging)
@@ -164,30 +207,269 @@ private:
     const Base& asBase() const { return *static_cast<const Base*> (this); }
     Base& asBase() { return *static_cast<Base*> (this); }
 
+    static juce::MouseEvent getEventRelativeToRow (const juce::MouseEvent& e, const juce::Rectangle<int> rowArea)
+    {
+        return e.withNewPosition (e.position - rowArea.getPosition().toFloat());
+    }
+
     int row = -1;
     bool selected = false, isDragging = false, isDraggingToScroll = false, selectRowOnMouseUp = false;
+    bool isMouseTakenByModel = false;
+};
+
+//==============================================================================
+/*  A least-recently-used cache of rendered rows, limited to a number of bytes. */
+class ListBox::RowImageCache
+{
+public:
+    struct Key
+    {
+        int row, width, height;
+        float scale;
+        bool selected, hovered;
+        juce::int64 contentVersion;
+
+        bool operator== (const Key& other) const noexcept
+        {
+            return row == other.row && width == other.width && height == other.height && scale == other.scale
+                   && selected == other.selected && hovered == other.hovered && contentVersion == other.contentVersion;
+        }
+    };
+
+    explicit RowImageCache (size_t maxBytesToUse) : maxBytes (maxBytesToUse) {}
+
+    const juce::Image* find (const Key& key)
+    {
+        const auto iter = lookup.find (key);
+
+        if (iter == lookup.end())
+            return nullptr;
+
+        entries.splice (entries.begin(), entries, iter->second);
+        return &iter->second->image;
+    }
+
+    void add (const Key& key, const juce::Image& image)
+    {
+        const auto bytes = (size_t) image.getWidth() * (size_t) image.getHeight() * 4;
+
+        if (bytes > maxBytes)
+            return;
+
+        const auto existing = lookup.find (key);
+
+        if (existing != lookup.end())
+            erase (existing->second);
+
+        entries.push_front ({ key, image, bytes });
+        lookup[key] = entries.begin();
+        usedBytes += bytes;
+
+        while (usedBytes > maxBytes)
+            erase (std::prev (entries.end()));
+    }
+
+    template <typename Predicate>
+    void removeIf (Predicate&& shouldRemove)
+    {
+        for (auto iter = entries.begin(); iter != entries.end();)
+        {
+            const auto next = std::next (iter);
+
+            if (shouldRemove (iter->key))
+                erase (iter);
+
+            iter = next;
+        }
+    }
+
+    void clear()
+    {
+        entries.clear();
+        lookup.clear();
+        usedBytes = 0;
+    }
+
+    size_t getMaxBytes() const noexcept { return maxBytes; }
+
+private:
+    struct Entry
+    {
+        Key key;
+        juce::Image image;
+        size_t bytes;
+    };
+
+    struct KeyHash
+    {
+        size_t operator() (const Key& k) const noexcept
+        {
+            auto h = std::hash<juce::int64>() (k.contentVersion);
+            h = h * 31 + (size_t) k.row;
+            h = h * 31 + (size_t) k.width;
+            h = h * 31 + (size_t) k.height;
+            h = h * 31 + (size_t) juce::roundToInt (k.scale * 100.0f);
+            return h * 4 + (k.selected ? 2 : 0) + (k.hovered ? 1 : 0);
+        }
+    };
+
+    using EntryList = std::list<Entry>;
+
+    void erase (EntryList::iterator iter)
+    {
+        usedBytes -= iter->bytes;
+        lookup.erase (iter->key);
+        entries.erase (iter);
+    }
+
+    size_t maxBytes, usedBytes = 0;
+    EntryList entries;
+    std::unordered_map<Key, EntryList::iterator, KeyHash> lookup;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RowImageCache)
+};
+
+//==============================================================================
+/*  Keeps the custom components of recycled rows, grouped by ListBoxModel::getRowTypeId(). */
+class CustomComponentPool
+{
+public:
+    void add (const int typeId, std::unique_ptr<juce::Component> component)
+    {
+        if (component == nullptr)
+            return;
+
+        if (auto* parent = component->getParentComponent())
+            parent->removeChildComponent (component.get());
+
+        spares[typeId].push_back (std::move (component));
+    }
+
+    std::unique_ptr<juce::Component> take (const int typeId)
+    {
+        const auto iter = spares.find (typeId);
+
+        if (iter == spares.end() || iter->second.empty())
+            return nullptr;
+
+        auto component = std::move (iter->second.back());
+        iter->second.pop_back();
+        return component;
+    }
+
+    void clear() { spares.clear(); }
+
+private:
+    std::map<int, std::vector<std::unique_ptr<juce::Component>>> spares;
 };
 
 class ListBox::RowComponent : public juce::TooltipClient,
                               public ComponentWithListRowMouseBehaviours<RowComponent>
 {
 public:
-    explicit RowComponent (ListBox& lb) : owner (lb) {}
+    RowComponent (ListBox& lb, CustomComponentPool& p) : owner (lb), pool (p) {}
 
     void paint (juce::Graphics& g) override
     {
+        // with the scroll cache or direct painting, the content component paints the rows underneath us
+        if (owner.scrollCacheEnabled || owner.directPaintEnabled)
+            return;
+
         if (auto* m = owner.getModel())
-            m->paintListBoxItem (getRow(), g, getWidth(), getHeight(), isSelected());
+        {
+            if (m->isRowReady (getRow()))
+                paintRow (*m, g);
+            else
+                m->paintRowPlaceholder (getRow(), g, getWidth(), getHeight(), isSelected());
+        }
+    }
+
+    void paintRow (ListBoxModel& m, juce::Graphics& g)
+    {
+        auto* cache = owner.rowImageCache.get();
+
+        if (cache == nullptr)
+        {
+            m.paintListBoxItem (getRow(), g, getWidth(), getHeight(), isSelected());
+            return;
+        }
+
+        const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const RowImageCache::Key key { getRow(), getWidth(), getHeight(), scale, isSelected(),
+                                       getRow() == owner.getHoveredRow(), m.getRowContentVersion (getRow()) };
+
+        if (auto* cached = cache->find (key))
+        {
+            g.drawImage (*cached, getLocalBounds().toFloat());
+            return;
+        }
+
+        juce::Image image (juce::Image::ARGB,
+                           juce::jmax (1, juce::roundToInt ((float) getWidth() * scale)),
+                           juce::jmax (1, juce::roundToInt ((float) getHeight() * scale)),
+                           true);
+
+        {
+            juce::Graphics imageGraphics (image);
+            imageGraphics.addTransform (juce::AffineTransform::scale (scale));
+            m.paintListBoxItem (getRow(), imageGraphics, getWidth(), getHeight(), isSelected());
+        }
+
+        cache->add (key, image);
+        g.drawImage (image, getLocalBounds().toFloat());
+    }
+
+    /*  True if update() has to be called for the row to catch up with its row number,
+        selection, ListBoxModel::getRowContentVersion() or a refresh of the whole list.
+    */
+    bool needsUpdate (const int newRow, const bool nowSelected, const juce::uint32 generation) const
+    {
+        if (newRow != getRow() || nowSelected != isSelected() || generation != contentGeneration)
+            return true;
+
+        auto* m = owner.getModel();
+        return m != nullptr && m->getRowContentVersion (newRow) != contentVersion;
     }
 
-    void update (const int newRow, const bool nowSelected)
+    void update (const int newRow, const bool nowSelected, const juce::uint32 generation)
     {
         updateRowAndSelection (newRow, nowSelected);
+        contentGeneration = generation;
+
+        // when painting directly, row components are only there for accessibility, and the
+        // content component underneath handles the mouse
+        setInterceptsMouseClicks (! owner.directPaintEnabled, ! owner.directPaintEnabled);
 
         if (auto* m = owner.getModel())
         {
+            contentVersion = m->getRowContentVersion (newRow);
             setMouseCursor (m->getMouseCursorForRow (getRow()));
 
+            if (owner.directPaintEnabled)
+            {
+                recycleCustomComponent();
+                return;
+            }
+
+            // until its data arrives, the row only paints a placeholder
+            if (! m->isRowReady (newRow))
+            {
+                if (customComponent != nullptr)
+                    customComponent->setVisible (false);
+
+                return;
+            }
+
+            // only ever hand the model a component that was made for the same type of row
+            const auto typeId = m->getRowTypeId (newRow);
+
+            if (customComponentTypeId != typeId)
+            {
+                recycleCustomComponent();
+                customComponent = pool.take (typeId);
+                customComponentTypeId = typeId;
+            }
+
             customComponent.reset (m->refreshComponentForRow (newRow, nowSelected, customComponent.release()));
 
             if (customComponent != nullptr)
@@ -240,8 +522,19 @@ public:
 
     ListBox& getOwner() const { return owner; }
 
+    juce::Rectangle<int> getRowArea() const { return getLocalBounds(); }
+
     Component* getCustomComponent() const { return customComponent.get(); }
 
+    void recycleCustomComponent()
+    {
+        if (customComponentTypeId.has_value())
+            pool.add (*customComponentTypeId, std::move (customComponent));
+
+        customComponent.reset();
+        customComponentTypeId.reset();
+    }
+
 private:
     //==============================================================================
     class RowAccessibilityHandler  : public juce::AccessibilityHandler
@@ -307,7 +600,11 @@ private:
 
     //==============================================================================
     ListBox& owner;
+    CustomComponentPool& pool;
     std::unique_ptr<Component> customComponent;
+    std::optional<int> customComponentTypeId;
+    juce::int64 contentVersion = 0;
+    juce::uint32 contentGeneration = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RowComponent)
 };
@@ -315,26 +612,80 @@ private:
 //==============================================================================
 class ListBox::ListViewport : public juce::Viewport
                             , private juce::Timer
+                            , private juce::ScrollBar::Listener
 {
 public:
     ListViewport (ListBox& lb) : owner (lb)
     {
         setWantsKeyboardFocus (false);
-        struct IgnoredComponent : Component
-        {
-            std::unique_ptr<juce::AccessibilityHandler> createAccessibilityHandler() override
-            {
-                return createIgnoredAccessibilityHandler (*this);
-            }
-        };
 
-        auto content = std::make_unique<IgnoredComponent>();
+        auto content = std::make_unique<Content> (*this);
         content->setWantsKeyboardFocus (false);
 
         setViewedComponent (content.release());
+
+        virtualScrollBar.addListener (this);
+        addChildComponent (virtualScrollBar);
+    }
+
+    //==============================================================================
+    /*  Lists taller than maxContentHeight are "virtualised": the content component stays
+        maxContentHeight tall and shows a window of the list starting at windowStart.
+        Row positions are kept in 64 bits, and the window moves along with the view, so
+        that row positions and scrolling by small amounts stay exact. A separate scrollbar,
+        with a double range, then stands in for the viewport's own one.
+
+        In smaller lists, the window starts at 0 and content and list positions are the same.
+    */
+    static constexpr int maxContentHeight = 1 << 24;
+
+    bool isVirtualised() const noexcept { return owner.rowHeights.getTotalHeight() > maxContentHeight; }
+
+    juce::int64 getVirtualViewY() const noexcept { return windowStart + getViewPositionY(); }
+
+    juce::int64 getMaxVirtualViewY() const noexcept
+    {
+        return juce::jmax<juce::int64> (0, owner.rowHeights.getTotalHeight() - getMaximumVisibleHeight());
+    }
+
+    /*  Converts a list position to the content component's coordinates. Positions far
+        outside the window are clamped, as they can't be on screen anyway.
+    */
+    int toContentY (const juce::int64 listY) const noexcept
+    {
+        return (int) juce::jlimit<juce::int64> (-maxContentHeight, 2 * maxContentHeight, listY - windowStart);
+    }
+
+    juce::int64 toListY (const int contentY) const noexcept { return windowStart + contentY; }
+
+    void setVirtualViewY (juce::int64 newY)
+    {
+        newY = juce::jlimit<juce::int64> (0, getMaxVirtualViewY(), newY);
+
+        const auto oldWindowStart = windowStart;
+        const auto viewY = newY - windowStart;
+
+        // move the window when the view gets near its edges, putting the view in its middle
+        if (! isVirtualised())
+            windowStart = 0;
+        else if (viewY < maxContentHeight / 4 || viewY > maxContentHeight * 3 / 4 - getMaximumVisibleHeight())
+            windowStart = juce::jlimit<juce::int64> (0, owner.rowHeights.getTotalHeight() - maxContentHeight,
+                                                     newY - (maxContentHeight - getMaximumVisibleHeight()) / 2);
+
+        const auto newViewPosition = (int) (newY - windowStart);
+
+        if (windowStart != oldWindowStart && newViewPosition == getViewPositionY())
+            updateContents();
+        else
+            setViewPosition (getViewPositionX(), newViewPosition);
+
+        // every row has moved within the content, even when the view position stays the same,
+        // and rows that are painted directly have no components to repaint themselves
+        if (windowStart != oldWindowStart)
+            getViewedComponent()->repaint();
     }
 
-    int getIndexOfFirstVisibleRow() const { return std::max (0, firstIndex - 1); }
+    int getIndexOfFirstMaterialisedRow() const { return firstMaterialisedRow; }
 
     RowComponent* getComponentForRow (int row) const noexcept
     {
@@ -347,7 +698,7 @@ public:
 
     RowComponent* getComponentForRowIfOnscreen (const int row) const noexcept
     {
-        const auto startIndex = getIndexOfFirstVisibleRow();
+        const auto startIndex = getIndexOfFirstMaterialisedRow();
         return (row >= startIndex && row < startIndex + static_cast<int>(rows.size()))
                    ? getComponentForRow (row)
                    : nullptr;
@@ -363,14 +714,73 @@ public:
 
         const auto index = (int) std::distance (rows.begin(), iter);
         const auto mod = std::max (1, (int) rows.size());
-        const auto startIndex = getIndexOfFirstVisibleRow();
+        const auto startIndex = getIndexOfFirstMaterialisedRow();
 
         return index + mod * ((startIndex / mod) + (index < (startIndex % mod) ? 1 : 0));
     }
 
+    /*  With estimated row heights, this measures the rows around the visible area. Rows
+        above the view changing height would make the content jump, so the row at the
+        top of the view is kept at the same position on screen.
+    */
+    void measureRowsNearView()
+    {
+        if (! owner.isEstimatingRowHeights() || owner.totalItems == 0 || isMeasuringRows)
+            return;
+
+        const juce::ScopedValueSetter<bool> svs (isMeasuringRows, true);
+
+        const auto& heights = owner.rowHeights;
+        const auto lastRow = owner.totalItems - 1;
+        const auto viewHeight = getMaximumVisibleHeight();
+        const auto margin = juce::jmax (viewHeight, owner.overscanPixels);
+
+        auto y = getVirtualViewY();
+        const auto anchorRow = juce::jlimit (0, lastRow, heights.getRowContaining (y));
+        const auto anchorOffset = y - heights.getRowY (anchorRow);
+        auto anyMeasured = false;
+
+        // measuring can shrink rows and pull more of them into range, so repeat until stable
+        for (;;)
+        {
+            const auto first = juce::jlimit (0, lastRow, heights.getRowContaining (y - margin));
+            const auto last = juce::jlimit (0, lastRow, heights.getRowContaining (y + viewHeight + margin));
+
+            if (! owner.measureRows ({ first, last + 1 }))
+                break;
+
+            anyMeasured = true;
+            y = heights.getRowY (anchorRow) + anchorOffset;
+        }
+
+        if (anyMeasured)
+        {
+            updateVisibleArea (false);
+            setVirtualViewY (y);
+        }
+    }
+
     void visibleAreaChanged (const juce::Rectangle<int>&) override
     {
+        // scrolling near the edges of a virtualised list's window moves the window,
+        // which comes back here with the new position
+        if (isVirtualised())
+        {
+            const auto viewY = getViewPositionY();
+            const auto maxViewY = getViewedComponent()->getHeight() - getMaximumVisibleHeight();
+
+            if ((viewY < maxContentHeight / 4 && windowStart > 0)
+                || (viewY > maxViewY - maxContentHeight / 4 && windowStart + maxViewY < getMaxVirtualViewY()))
+            {
+                setVirtualViewY (getVirtualViewY());
+                return;
+            }
+        }
+
         updateVisibleArea (true);
+        updateVirtualScrollBar();
+
+        owner.updateHoveredRow();
 
         if (auto* m = owner.getModel())
             m->listWasScrolled();
@@ -383,15 +793,18 @@ public:
         hasUpdated = false;
 
         auto& content = *getViewedComponent();
+        const auto virtualised = isVirtualised();
+
+        if (virtualised != isUsingVirtualScrollBar)
+            setVirtualised (virtualised);
+
         auto newX = content.getX();
         auto newY = content.getY();
-        auto newW = std::max<int> (owner.minimumRowWidth, getMaximumVisibleWidth());
-        int newH = 0;
-        for (auto i = 0; i < owner.totalItems; i++)
-        {
-            jassert (owner.model != nullptr);
-            newH += owner.getRowHeight (i);
-        }
+        auto newW = std::max<int> (owner.minimumRowWidth, getMaximumVisibleWidth() - (virtualised ? getScrollBarThickness() : 0));
+        auto newH = (int) juce::jmin<juce::int64> (owner.rowHeights.getTotalHeight(), maxContentHeight);
+
+        if (! virtualised)
+            windowStart = 0;
 
         if (newY + newH < getMaximumVisibleHeight() && newH > getMaximumVisibleHeight())
             newY = getMaximumVisibleHeight() - newH;
@@ -402,47 +815,84 @@ public:
             updateContents();
     }
 
-    void updateContents()
+    /*  Lays out the rows around the view. Row components are only updated if they show
+        a different row, selection or content version than last time, or if they're
+        in rowsToRefresh or refreshAllRows() was called since.
+    */
+    void updateContents (juce::Range<int> rowsToRefresh = {})
     {
         if (getMaximumVisibleHeight() > 0)
             hasUpdated = true;
 
+        measureRowsNearView();
+
         auto& content = *getViewedComponent();
 
-        if (owner.totalItems > 0 && owner.itemHeightSum.back() > 0)
+        const auto& heights = owner.rowHeights;
+
+        if (owner.totalItems > 0 && heights.getTotalHeight() > 0)
         {
-            auto y = getViewPositionY();
-            auto w = content.getWidth();
+            const auto y = getVirtualViewY();
+            const auto w = content.getWidth();
+            const auto bottom = y + getMaximumVisibleHeight();
+
+            firstIndex = juce::jlimit (0, owner.totalItems - 1, heights.getRowContaining (y));
+            firstWholeIndex = heights.getRowY (firstIndex) < y ? firstIndex + 1 : firstIndex;
+            owner.rememberTopRow (firstIndex, (int) (y - heights.getRowY (firstIndex)));
 
-            const auto first = std::lower_bound (owner.itemHeightSum.begin(), owner.itemHeightSum.end(), y);
-            firstIndex = static_cast<int> (first - owner.itemHeightSum.begin());
-            firstWholeIndex = *first > y ? firstIndex + 1 : firstWholeIndex;
+            const auto lastIndex = juce::jlimit (firstIndex, owner.totalItems - 1, heights.getRowContaining (bottom - 1));
+            lastWholeIndex = heights.getRowBottom (lastIndex) <= bottom ? lastIndex : lastIndex - 1;
 
-            const auto last = std::lower_bound (first, owner.itemHeightSum.end(), juce::jmax (1, y + getMaximumVisibleHeight() - 1));
-            const auto lastIndex = last - owner.itemHeightSum.begin();
+            // overscan: create rows outside the view too, mostly in the direction we're scrolling
+            if (y != lastViewY)
+                scrollDirection = y > lastViewY ? 1 : -1;
 
-            const auto previousLastIndex = juce::jmax (0, static_cast<int> (lastIndex - 1));
-            lastWholeIndex = owner.itemHeightSum.at ((size_t) previousLastIndex) <= y + getMaximumVisibleHeight() ? previousLastIndex : static_cast<int> (lastIndex);
+            lastViewY = y;
+
+            const auto overscan = owner.overscanPixels;
+            const auto overscanAbove = scrollDirection < 0 ? overscan * 3 / 4 : overscan / 4;
+            const auto overscanBelow = overscan - overscanAbove;
+
+            firstMaterialisedRow = juce::jlimit (0, firstIndex, heights.getRowContaining (y - overscanAbove));
+            const auto lastMaterialisedRow = juce::jlimit (lastIndex, owner.totalItems - 1, heights.getRowContaining (bottom - 1 + overscanBelow));
+
+            prefetchAhead (firstMaterialisedRow, lastMaterialisedRow);
+
+            // painting directly only needs row components to represent the rows to accessibility clients
+            const auto needsRowComponents = ! owner.directPaintEnabled || juce::AccessibilityHandler::areAnyAccessibilityClientsActive();
+            const size_t numNeeded = needsRowComponents ? static_cast<size_t> (std::min (owner.totalItems, 2 + lastMaterialisedRow - firstMaterialisedRow))
+                                                        : 0;
+
+            for (auto i = numNeeded; i < rows.size(); ++i)
+                rows[i]->recycleCustomComponent();
 
-            const size_t numNeeded = static_cast<size_t> (std::min (owner.totalItems, 2 + static_cast<int> (lastIndex - firstWholeIndex)));
             rows.resize (std::min (numNeeded, rows.size()));
 
             while (numNeeded > rows.size())
             {
-                rows.push_back (std::make_unique<RowComponent> (owner));
+                rows.push_back (std::make_unique<RowComponent> (owner, recycledComponents));
                 content.addAndMakeVisible (rows.back().get());
             }
 
             for (size_t i = 0; i < numNeeded; ++i)
             {
-                const auto row = static_cast<int> (i) + firstIndex;
+                const auto row = static_cast<int> (i) + firstMaterialisedRow;
                 if (auto* rowComp = getComponentForRow (row))
                 {
-                    auto height = owner.getRowHeight (row);
-                    rowComp->setBounds (0, getRowY (row), w, height);
-                    rowComp->update (row, owner.isRowSelected (row));
+                    const juce::Rectangle<int> bounds (0, toContentY (getRowY (row)), w, owner.getRowHeight (row));
+
+                    if (rowComp->getBounds() != bounds)
+                        rowComp->setBounds (bounds);
+
+                    const auto isSelected = owner.isRowSelected (row);
+
+                    if (rowsToRefresh.contains (row) || rowComp->needsUpdate (row, isSelected, contentGeneration))
+                        rowComp->update (row, isSelected, contentGeneration);
                 }
             }
+
+            if (owner.directPaintEnabled)
+                repaintChangedRows ({ firstIndex, lastIndex + 1 }, rowsToRefresh);
         }
 
         if (owner.headerComponent != nullptr)
@@ -453,69 +903,187 @@ public:
                                               owner.headerComponent->getHeight());
     }
 
-    int getRowY (const int row)
+    void clearRecycledComponents() { recycledComponents.clear(); }
+
+    /*  Makes the next updateContents() update every row component. */
+    void refreshAllRows() { ++contentGeneration; }
+
+    //==============================================================================
+    void clearTiles()
     {
-        if (row == 0)
-            return 0;
-        else if (row >= owner.totalItems)
-            return owner.itemHeightSum.back() + owner.getDefaultRowHeight() * (1 + row - owner.totalItems);
-        else
-            return owner.itemHeightSum[static_cast<size_t> (row - 1)];
+        tiles.clear();
+        tileOrigin = 0;
     }
 
-    void selectRow (const int row, const int /*rowH*/, const bool dontScroll, const int lastSelectedRow, const int totalRows, const bool isMouseClick)
+    /*  Drops the tiles showing any of these rows. Tiles also check the selection and the
+        ListBoxModel::getRowContentVersion() of their rows when painted, so this is only
+        needed for other content changes.
+    */
+    void invalidateTiles (const juce::Range<int> rowsToInvalidate)
     {
-        hasUpdated = false;
+        const auto& heights = owner.rowHeights;
+        const auto start = juce::jlimit (0, heights.size(), rowsToInvalidate.getStart());
+        const auto end = juce::jlimit (start, heights.size(), rowsToInvalidate.getEnd());
 
-        if (row < firstWholeIndex && ! dontScroll)
-        {
-            setViewPosition (getViewPositionX(), getRowY (row));
-        }
-        else if (row >= lastWholeIndex && ! dontScroll)
+        if (tiles.empty() || start == end)
+            return;
+
+        tiles.erase (tiles.lower_bound (getTileIndex (heights.getRowY (start))),
+                     tiles.upper_bound (getTileIndex (heights.getRowY (end) - 1)));
+    }
+
+    /*  Drops the tiles from a list position downwards, after the rows there have moved. */
+    void invalidateTilesFrom (const juce::int64 listY)
+    {
+        tiles.erase (tiles.lower_bound (getTileIndex (juce::jmax<juce::int64> (0, listY))), tiles.end());
+    }
+
+    /*  Keeps the tiles when rows are removed from the start of the list. The tiles are
+        indexed from the top of the rows that were removed before, so the remaining rows
+        stay in the same place in them.
+    */
+    void firstRowsRemoved (const int numRows, const juce::int64 removedHeight)
+    {
+        tileOrigin += removedHeight;
+
+        for (auto& entry : tiles)
         {
-            const int rowsOnScreen = lastWholeIndex - firstWholeIndex;
+            auto& tile = entry.second;
+            tile.firstRow -= numRows;
 
-            if (row >= lastSelectedRow + rowsOnScreen
-                && rowsOnScreen < totalRows - 1
-                && ! isMouseClick)
+            if (tile.firstRow < 0)
             {
-                setViewPosition (getViewPositionX(),
-                                 getRowY (juce::jlimit (0, juce::jmax (0, totalRows - rowsOnScreen), row)));
-            }
-            else
-            {
-                auto bottom = getViewPositionY() + getMaximumVisibleHeight();
-                jassert (row >= 0);
-                setViewPosition (getViewPositionX(), getViewPositionY() + (owner.itemHeightSum.at ((size_t) row) - bottom));
+                const auto numGone = (std::ptrdiff_t) juce::jmin (-tile.firstRow, (int) tile.rowSelection.size());
+                tile.rowSelection.erase (tile.rowSelection.begin(), tile.rowSelection.begin() + numGone);
+                tile.rowContentVersions.erase (tile.rowContentVersions.begin(), tile.rowContentVersions.begin() + numGone);
+                tile.firstRow = 0;
             }
         }
-
-        if (! hasUpdated)
-            updateContents();
     }
 
-    void scrollToEnsureRowIsOnscreen (const int row)
+    void refreshAndRepaintRows (const juce::SparseSet<int>& rowsToRefresh)
     {
-        jassert (row >= 0);
-        if (row < firstWholeIndex)
+        for (auto i = 0; i < rowsToRefresh.getNumRanges(); ++i)
         {
-            setViewPosition (getViewPositionX(), getRowY (row));
+            invalidateTiles (rowsToRefresh.getRange (i));
+
+            if (owner.directPaintEnabled)
+                repaintRows (rowsToRefresh.getRange (i).getIntersectionWith (paintedRows));
         }
-        else if (row >= lastWholeIndex)
+
+        for (size_t i = 0; i < rows.size(); ++i)
         {
-            auto bottom = getViewPositionY() + getMaximumVisibleHeight();
-            setViewPosition (getViewPositionX(),
-                             std::max<int> (0, getViewPositionY() + (owner.itemHeightSum.at (size_t (row) + 1) - bottom)));
+            const auto row = static_cast<int> (i) + firstMaterialisedRow;
+
+            if (rowsToRefresh.contains (row))
+            {
+                if (auto* rowComp = getComponentForRow (row))
+                {
+                    rowComp->update (row, owner.isRowSelected (row), contentGeneration);
+                    rowComp->repaint();
+                }
+            }
         }
     }
 
-    void paint (juce::Graphics& g) override
+    /*  Lets the model warm up the page of rows that follows the materialised ones in the
+        direction of scrolling. It's only called when that page changes.
+    */
+    void prefetchAhead (const int firstMaterialised, const int lastMaterialised)
     {
-        if (isOpaque())
-            g.fillAll (owner.findColour (ListBox::backgroundColourId));
-    }
+        auto* m = owner.getModel();
 
-    bool keyPressed (const juce::KeyPress& key) override
+        if (m == nullptr)
+            return;
+
+        const auto& heights = owner.rowHeights;
+        const auto pageHeight = getMaximumVisibleHeight();
+        juce::Range<int> rowsAhead;
+
+        if (scrollDirection < 0)
+        {
+            const auto top = heights.getRowY (firstMaterialised);
+            rowsAhead = { juce::jmax (0, heights.getRowContaining (top - pageHeight)), firstMaterialised };
+        }
+        else
+        {
+            const auto bottom = heights.getRowBottom (lastMaterialised);
+            rowsAhead = { lastMaterialised + 1, juce::jmin (owner.totalItems, heights.getRowContaining (bottom + pageHeight) + 1) };
+        }
+
+        if (! rowsAhead.isEmpty() && rowsAhead != lastPrefetchedRows)
+            m->prefetchRows (rowsAhead);
+
+        lastPrefetchedRows = rowsAhead;
+    }
+
+    juce::int64 getRowY (const int row) const
+    {
+        if (row >= owner.totalItems)
+            return owner.rowHeights.getTotalHeight() + (juce::int64) owner.getDefaultRowHeight() * (row - owner.totalItems);
+
+        return owner.rowHeights.getRowY (juce::jmax (0, row));
+    }
+
+    void selectRow (const int row, const int /*rowH*/, const bool dontScroll, const int lastSelectedRow, const int totalRows, const bool isMouseClick)
+    {
+        hasUpdated = false;
+
+        if (! dontScroll)
+            owner.measureRows ({ row, row + 1 });
+
+        if (row < firstWholeIndex && ! dontScroll)
+        {
+            setVirtualViewY (getRowY (row));
+        }
+        else if (row >= lastWholeIndex && ! dontScroll)
+        {
+            const int rowsOnScreen = lastWholeIndex - firstWholeIndex;
+
+            if (row >= lastSelectedRow + rowsOnScreen
+                && rowsOnScreen < totalRows - 1
+                && ! isMouseClick)
+            {
+                setVirtualViewY (getRowY (juce::jlimit (0, juce::jmax (0, totalRows - rowsOnScreen), row)));
+            }
+            else
+            {
+                jassert (row >= 0);
+                setVirtualViewY (owner.rowHeights.getRowBottom (row) - getMaximumVisibleHeight());
+            }
+        }
+
+        if (! hasUpdated)
+            updateContents();
+    }
+
+    void scrollToEnsureRowIsOnscreen (const int row)
+    {
+        jassert (row >= 0);
+        owner.measureRows ({ row, row + 1 });
+
+        if (row < firstWholeIndex)
+            setVirtualViewY (getRowY (row));
+        else if (row >= lastWholeIndex)
+            setVirtualViewY (getRowY (row + 1) - getMaximumVisibleHeight());
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        if (isOpaque())
+            g.fillAll (owner.findColour (ListBox::backgroundColourId));
+    }
+
+    void resized() override
+    {
+        Viewport::resized();
+
+        const auto thickness = getScrollBarThickness();
+        virtualScrollBar.setBounds (getLocalBounds().removeFromRight (thickness)
+                                                    .withTrimmedBottom (getHorizontalScrollBar().isVisible() ? thickness : 0));
+    }
+
+    bool keyPressed (const juce::KeyPress& key) override
     {
         if (Viewport::respondsToKey (key))
         {
@@ -533,6 +1101,309 @@ public:
     }
 
 private:
+    //==============================================================================
+    /*  Paints the rows itself with the scroll cache or in direct paint mode. In direct paint
+        mode it also stands in for the row components, finding the rows from the height index.
+    */
+    class Content : public ComponentWithListRowMouseBehaviours<Content>
+                  , public juce::TooltipClient
+    {
+    public:
+        explicit Content (ListViewport& vp) : viewport (vp) {}
+
+        void paint (juce::Graphics& g) override
+        {
+            if (viewport.owner.scrollCacheEnabled)
+                viewport.paintTiles (g);
+            else if (viewport.owner.directPaintEnabled)
+                viewport.paintRows (g, g.getClipBounds());
+        }
+
+        void mouseDown (const juce::MouseEvent& e) override
+        {
+            if (! viewport.owner.directPaintEnabled)
+                return;
+
+            const auto row = viewport.getRowAtContentY (e.y);
+            setRowAndSelection (row, viewport.owner.isRowSelected (row));
+
+            if (row >= 0)
+                ComponentWithListRowMouseBehaviours::mouseDown (e);
+        }
+
+        void mouseUp (const juce::MouseEvent& e) override
+        {
+            if (viewport.owner.directPaintEnabled && getRow() >= 0)
+                ComponentWithListRowMouseBehaviours::mouseUp (e);
+        }
+
+        void mouseDrag (const juce::MouseEvent& e) override
+        {
+            if (viewport.owner.directPaintEnabled && getRow() >= 0)
+                ComponentWithListRowMouseBehaviours::mouseDrag (e);
+        }
+
+        void mouseDoubleClick (const juce::MouseEvent& e) override
+        {
+            if (! viewport.owner.directPaintEnabled || ! isEnabled())
+                return;
+
+            const auto row = viewport.getRowAtContentY (e.y);
+
+            if (auto* m = viewport.owner.getModel())
+                if (row >= 0)
+                    m->listBoxItemDoubleClicked (row, e);
+        }
+
+        void performSelection (const juce::MouseEvent& e, const bool isMouseUp)
+        {
+            viewport.owner.selectRowsBasedOnModifierKeys (getRow(), e.mods, isMouseUp);
+
+            if (auto* m = viewport.owner.getModel())
+                m->listBoxItemClicked (getRow(), e);
+        }
+
+        juce::String getTooltip() override
+        {
+            const auto row = getRowUnderMouse();
+
+            if (auto* m = viewport.owner.getModel())
+                if (row >= 0)
+                    return m->getTooltipForRow (row);
+
+            return {};
+        }
+
+        juce::MouseCursor getMouseCursor() override
+        {
+            const auto row = getRowUnderMouse();
+
+            if (auto* m = viewport.owner.getModel())
+                if (row >= 0)
+                    return m->getMouseCursorForRow (row);
+
+            return Component::getMouseCursor();
+        }
+
+        std::unique_ptr<juce::AccessibilityHandler> createAccessibilityHandler() override
+        {
+            return createIgnoredAccessibilityHandler (*this);
+        }
+
+        ListBox& getOwner() const { return viewport.owner; }
+
+        juce::Rectangle<int> getRowArea() const
+        {
+            return { 0, viewport.toContentY (viewport.getRowY (getRow())), getWidth(), viewport.owner.getRowHeight (getRow()) };
+        }
+
+    private:
+        int getRowUnderMouse() const
+        {
+            return viewport.owner.directPaintEnabled ? viewport.getRowAtContentY (getMouseXYRelative().y) : -1;
+        }
+
+        ListViewport& viewport;
+    };
+
+    /*  A horizontal strip of the rendered rows, along with what it was rendered for. */
+    struct Tile
+    {
+        juce::Image image;
+        float scale = 0.0f;
+        int width = 0, firstRow = 0;
+        std::vector<bool> rowSelection;
+        std::vector<juce::int64> rowContentVersions;
+    };
+
+    static constexpr int tileHeight = 256;
+
+    /*  Tiles are counted from tileOrigin above the first row, which grows as rows are
+        evicted from the start of the list so that the tiles below them can be kept.
+    */
+    juce::int64 getTileIndex (const juce::int64 listY) const  { return (listY + tileOrigin) / tileHeight; }
+    juce::int64 getTileTop (const juce::int64 index) const    { return index * tileHeight - tileOrigin; }
+
+    void paintTiles (juce::Graphics& g)
+    {
+        if (! owner.scrollCacheEnabled || owner.totalItems == 0 || owner.getModel() == nullptr)
+            return;
+
+        const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        const auto width = getViewedComponent()->getWidth();
+        const auto area = g.getClipBounds().getIntersection (getViewedComponent()->getLocalBounds());
+
+        if (area.isEmpty())
+            return;
+
+        // tiles are indexed by their list position, so they stay valid when the window moves
+        for (auto index = getTileIndex (toListY (area.getY())); getTileTop (index) < toListY (area.getBottom()); ++index)
+        {
+            auto& tile = tiles[index];
+
+            if (! isTileValid (tile, scale, width))
+                renderTile (tile, index, scale, width);
+
+            g.drawImage (tile.image, juce::Rectangle<int> (0, toContentY (getTileTop (index)), width, tileHeight).toFloat());
+        }
+
+        removeTilesAwayFromView();
+    }
+
+    bool isTileValid (const Tile& tile, const float scale, const int width) const
+    {
+        if (! tile.image.isValid() || tile.scale != scale || tile.width != width)
+            return false;
+
+        auto* m = owner.getModel();
+
+        for (size_t i = 0; i < tile.rowSelection.size(); ++i)
+        {
+            const auto row = tile.firstRow + (int) i;
+
+            if (owner.isRowSelected (row) != tile.rowSelection[i] || m->getRowContentVersion (row) != tile.rowContentVersions[i])
+                return false;
+        }
+
+        return true;
+    }
+
+    void renderTile (Tile& tile, const juce::int64 index, const float scale, const int width)
+    {
+        const auto& heights = owner.rowHeights;
+        const auto top = getTileTop (index);
+
+        tile.image = juce::Image (juce::Image::ARGB,
+                                  juce::jmax (1, juce::roundToInt ((float) width * scale)),
+                                  juce::roundToInt ((float) tileHeight * scale),
+                                  true);
+        tile.scale = scale;
+        tile.width = width;
+        tile.firstRow = juce::jlimit (0, owner.totalItems - 1, heights.getRowContaining (top));
+        tile.rowSelection.clear();
+        tile.rowContentVersions.clear();
+
+        auto& m = *owner.getModel();
+        juce::Graphics g (tile.image);
+        g.addTransform (juce::AffineTransform::scale (scale));
+
+        for (auto row = tile.firstRow, y = (int) (heights.getRowY (row) - top); row < owner.totalItems && y < tileHeight; ++row)
+        {
+            const auto h = heights.getHeight (row);
+            const auto isSelected = owner.isRowSelected (row);
+            tile.rowSelection.push_back (isSelected);
+            tile.rowContentVersions.push_back (m.getRowContentVersion (row));
+
+            paintRow (m, g, row, y, width, h, isSelected);
+            y += h;
+        }
+    }
+
+    static void paintRow (ListBoxModel& m, juce::Graphics& g, const int row, const int y, const int width, const int height, const bool isSelected)
+    {
+        const juce::Graphics::ScopedSaveState sss (g);
+        g.setOrigin (0, y);
+
+        if (! g.reduceClipRegion (0, 0, width, height))
+            return;
+
+        if (m.isRowReady (row))
+            m.paintListBoxItem (row, g, width, height, isSelected);
+        else
+            m.paintRowPlaceholder (row, g, width, height, isSelected);
+    }
+
+    //==============================================================================
+    /*  Paints the rows in an area of the content component in one pass, in direct paint mode. */
+    void paintRows (juce::Graphics& g, const juce::Rectangle<int> area)
+    {
+        auto* m = owner.getModel();
+
+        if (m == nullptr || owner.totalItems == 0 || area.isEmpty())
+            return;
+
+        const auto& heights = owner.rowHeights;
+        const auto width = getViewedComponent()->getWidth();
+
+        for (auto row = juce::jlimit (0, owner.totalItems - 1, heights.getRowContaining (toListY (area.getY()))); row < owner.totalItems; ++row)
+        {
+            const auto y = toContentY (heights.getRowY (row));
+
+            if (y >= area.getBottom())
+                break;
+
+            paintRow (*m, g, row, y, width, heights.getHeight (row), owner.isRowSelected (row));
+        }
+    }
+
+    /*  Returns the row at a y position in the content component, or -1 if there isn't one. */
+    int getRowAtContentY (const int y) const
+    {
+        const auto row = owner.rowHeights.getRowContaining (toListY (y));
+        return juce::isPositiveAndBelow (row, owner.totalItems) ? row : -1;
+    }
+
+    /*  Returns the rows that are at least partly inside the visible area. */
+    juce::Range<int> getVisibleRows() const
+    {
+        const auto& heights = owner.rowHeights;
+        const auto top = getVirtualViewY();
+        const auto first = juce::jlimit (0, heights.size(), heights.getRowContaining (top));
+        const auto last = juce::jlimit (first, heights.size(), heights.getRowContaining (top + getViewHeight() - 1) + 1);
+
+        return { first, last };
+    }
+
+    void repaintRows (const juce::Range<int> rowsToRepaint)
+    {
+        const auto& heights = owner.rowHeights;
+        const auto start = juce::jlimit (0, heights.size(), rowsToRepaint.getStart());
+        const auto end = juce::jlimit (start, heights.size(), rowsToRepaint.getEnd());
+
+        if (start == end)
+            return;
+
+        const auto top = toContentY (heights.getRowY (start));
+        getViewedComponent()->repaint (0, top, getViewedComponent()->getWidth(), toContentY (heights.getRowY (end)) - top);
+    }
+
+    /*  In direct paint mode there are no row components to notice that their row changed,
+        so this keeps what each visible row was painted with, and repaints the ones that
+        are different now. Rows that have just scrolled into view get painted anyway.
+    */
+    void repaintChangedRows (const juce::Range<int> visibleRows, const juce::Range<int> rowsToRefresh)
+    {
+        auto* m = owner.getModel();
+        std::vector<PaintedRow> nowPainted;
+        nowPainted.reserve ((size_t) visibleRows.getLength());
+
+        for (auto row = visibleRows.getStart(); row < visibleRows.getEnd(); ++row)
+        {
+            const PaintedRow painted { owner.isRowSelected (row), m != nullptr ? m->getRowContentVersion (row) : 0, contentGeneration };
+            const auto index = row - paintedRows.getStart();
+
+            if (rowsToRefresh.contains (row)
+                || (juce::isPositiveAndBelow (index, (int) paintedRowStates.size()) && paintedRowStates[(size_t) index] != painted))
+                repaintRows ({ row, row + 1 });
+
+            nowPainted.push_back (painted);
+        }
+
+        paintedRows = visibleRows;
+        paintedRowStates = std::move (nowPainted);
+    }
+
+    void removeTilesAwayFromView()
+    {
+        const auto margin = juce::jmax (tileHeight, owner.overscanPixels);
+        const auto firstKept = getTileIndex (juce::jmax<juce::int64> (0, getVirtualViewY() - margin));
+        const auto lastKept = getTileIndex (getVirtualViewY() + getMaximumVisibleHeight() + margin);
+
+        tiles.erase (tiles.begin(), tiles.lower_bound (firstKept));
+        tiles.erase (tiles.upper_bound (lastKept), tiles.end());
+    }
+
+    //==============================================================================
     std::unique_ptr<juce::AccessibilityHandler> createAccessibilityHandler() override
     {
         return createIgnoredAccessibilityHandler (*this);
@@ -546,10 +1417,74 @@ private:
             handler->notifyAccessibilityEvent (juce::AccessibilityEvent::structureChanged);
     }
 
+    //==============================================================================
+    /*  Swaps the viewport's vertical scrollbar for the virtual one, which covers the
+        whole list rather than the content window.
+    */
+    void setVirtualised (const bool shouldBeVirtualised)
+    {
+        isUsingVirtualScrollBar = shouldBeVirtualised;
+
+        if (shouldBeVirtualised)
+        {
+            showedVerticalScrollBar = isVerticalScrollBarShown();
+            setScrollBarsShown (false, isHorizontalScrollBarShown(), true, false);
+        }
+        else
+        {
+            windowStart = 0;
+            setScrollBarsShown (showedVerticalScrollBar, isHorizontalScrollBarShown());
+        }
+
+        virtualScrollBar.setVisible (shouldBeVirtualised && showedVerticalScrollBar);
+        resized();
+        clearTiles();
+    }
+
+    void updateVirtualScrollBar()
+    {
+        if (! virtualScrollBar.isVisible())
+            return;
+
+        virtualScrollBar.setRangeLimits (0.0, (double) owner.rowHeights.getTotalHeight(), juce::dontSendNotification);
+        virtualScrollBar.setCurrentRange ((double) getVirtualViewY(), (double) getMaximumVisibleHeight(), juce::dontSendNotification);
+        virtualScrollBar.setSingleStepSize ((double) owner.getDefaultRowHeight());
+    }
+
+    void scrollBarMoved (juce::ScrollBar* bar, const double newRangeStart) override
+    {
+        if (bar == &virtualScrollBar)
+            setVirtualViewY ((juce::int64) newRangeStart);
+    }
+
     ListBox& owner;
+    CustomComponentPool recycledComponents;
     std::vector<std::unique_ptr<RowComponent>> rows;
-    int firstIndex = 0, firstWholeIndex = 0, lastWholeIndex = 0;
-    bool hasUpdated = false;
+    std::map<juce::int64, Tile> tiles;
+    juce::int64 tileOrigin = 0;
+
+    struct PaintedRow
+    {
+        bool selected;
+        juce::int64 contentVersion;
+        juce::uint32 generation;
+
+        bool operator!= (const PaintedRow& other) const noexcept
+        {
+            return selected != other.selected || contentVersion != other.contentVersion || generation != other.generation;
+        }
+    };
+
+    juce::Range<int> paintedRows;
+    std::vector<PaintedRow> paintedRowStates;
+    juce::ScrollBar virtualScrollBar { true };
+    juce::int64 windowStart = 0, lastViewY = 0;
+    juce::uint32 contentGeneration = 1;
+    int firstIndex = 0, firstWholeIndex = 0, lastWholeIndex = 0, firstMaterialisedRow = 0;
+    int scrollDirection = 0;
+    bool isUsingVirtualScrollBar = false, showedVerticalScrollBar = true;
+    juce::Range<int> lastPrefetchedRows;
+    bool hasUpdated = false, isMeasuringRows = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ListViewport)
 };
@@ -582,6 +1517,46 @@ struct ListBoxMouseMoveSelector : public juce::MouseListener
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ListBoxMouseMoveSelector)
 };
 
+//==============================================================================
+class ListBox::HoverTracker : public juce::MouseListener
+{
+public:
+    HoverTracker (ListBox& lb) : owner (lb)
+    {
+        owner.addMouseListener (this, true);
+    }
+
+    ~HoverTracker() override
+    {
+        owner.removeMouseListener (this);
+    }
+
+    void mouseMove (const juce::MouseEvent& e) override
+    {
+        update (e.getEventRelativeTo (&owner).position.toInt());
+    }
+
+    void mouseExit (const juce::MouseEvent& e) override
+    {
+        // moving between rows exits one and enters the next, so check where the mouse went
+        const auto pos = e.getEventRelativeTo (&owner).position.toInt();
+
+        if (owner.getLocalBounds().contains (pos))
+            update (pos);
+        else
+            owner.setHoveredRow (-1);
+    }
+
+    void update (const juce::Point<int> pos)
+    {
+        owner.setHoveredRow (owner.getRowContainingPosition (pos.x, pos.y));
+    }
+
+private:
+    ListBox& owner;
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HoverTracker)
+};
+
 //==============================================================================
 ListBox::ListBox (const juce::String& name, ListBoxModel* const m)
     : Component (name)
@@ -593,11 +1568,15 @@ ListBox::ListBox (const juce::String& name, ListBoxModel* const m)
     setFocusContainerType (FocusContainerType::focusContainer);
     colourChanged();
 
+    vBlankAttachment = std::make_unique<juce::VBlankAttachment> (this, [this] { handleFrameUpdate(); });
+
     assignModelPtr (m);
 }
 
 ListBox::~ListBox()
 {
+    vBlankAttachment.reset();
+    hoverTracker.reset();
     headerComponent.reset();
     viewport.reset();
 }
@@ -615,6 +1594,11 @@ void ListBox::setModel (ListBoxModel* const newModel)
 {
     if (model != newModel)
     {
+        viewport->clearRecycledComponents();
+        selectedKeys.clear();
+        lastSelectedKey.reset();
+        topRowKey.reset();
+        topRowKeyRow = -1;
         assignModelPtr (newModel);
         repaint();
         updateContent();
@@ -638,85 +1622,561 @@ void ListBox::setMouseMoveSelectsRows (bool b)
     }
 }
 
+void ListBox::setHoverTrackingEnabled (const bool shouldTrack)
+{
+    if (shouldTrack == (hoverTracker != nullptr))
+        return;
+
+    if (shouldTrack)
+        hoverTracker = std::make_unique<HoverTracker> (*this);
+    else
+        hoverTracker.reset();
+
+    setHoveredRow (-1);
+}
+
+void ListBox::updateHoveredRow()
+{
+    // the mouse can end up over a different row without moving, e.g. when scrolling
+    if (hoverTracker != nullptr && isMouseOver (true))
+        hoverTracker->update (getMouseXYRelative());
+}
+
+void ListBox::setHoveredRow (const int row)
+{
+    const auto newRow = juce::isPositiveAndBelow (row, totalItems) ? row : -1;
+
+    if (newRow == hoveredRow)
+        return;
+
+    const auto oldRow = std::exchange (hoveredRow, newRow);
+
+    if (oldRow >= 0)
+        repaintRow (oldRow);
+
+    if (newRow >= 0)
+        repaintRow (newRow);
+
+    if (model != nullptr)
+        model->hoveredRowChanged (newRow);
+}
+
 //==============================================================================
 void ListBox::paint (juce::Graphics& g)
 {
     if (! hasDoneInitialUpdate)
         updateContent();
 
-    g.fillAll (findColour (backgroundColourId));
+    g.fillAll (findColour (backgroundColourId));
+}
+
+void ListBox::paintOverChildren (juce::Graphics& g)
+{
+    if (outlineThickness > 0)
+    {
+        g.setColour (findColour (outlineColourId));
+        g.drawRect (getLocalBounds(), outlineThickness);
+    }
+}
+
+void ListBox::resized()
+{
+    viewport->setBoundsInset (juce::BorderSize<int> (outlineThickness + (headerComponent != nullptr ? headerComponent->getHeight() : 0),
+                                                     outlineThickness,
+                                                     outlineThickness,
+                                                     outlineThickness));
+
+    viewport->setSingleStepSizes (20, getDefaultRowHeight());
+
+    viewport->updateVisibleArea (false);
+}
+
+void ListBox::visibilityChanged()
+{
+    viewport->updateVisibleArea (true);
+}
+
+juce::Viewport* ListBox::getViewport() const noexcept
+{
+    return viewport.get();
+}
+
+//==============================================================================
+void ListBox::updateContent()
+{
+    checkModelPtrIsValid();
+    hasDoneInitialUpdate = true;
+    totalItems = (model != nullptr) ? model->getNumRows() : 0;
+
+    // the key was taken on an earlier frame, while the model still matched the rows
+    const auto previousTopRowKey = topRowKey;
+    const auto previousTopRowOffset = topRowKeyOffset;
+    topRowKeyRow = -1;
+
+    if (rowImageCache != nullptr)
+        rowImageCache->clear();
+
+    viewport->clearTiles();
+    viewport->refreshAllRows();
+    estimatedRowHeight = model != nullptr ? model->getEstimatedRowHeight() : -1;
+    measuredRows.clear();
+    lastRowRepaintTimes.clear();
+
+    if (isEstimatingRowHeights())
+        rowHeights.buildUniform (totalItems, estimatedRowHeight);
+    else if (model == nullptr || model->hasUniformRowHeights())
+        rowHeights.buildUniform (totalItems, getRowHeightFromModel (0));
+    else
+        rowHeights.build (totalItems, getDefaultRowHeight(), [this] (juce::Range<int> rows, int* dest) { fillRowHeights (rows, dest); });
+
+    auto selectionChanged = remapSelectionToKeys();
+
+    if (selected.getTotalRange().getEnd() > totalItems)
+    {
+        removeFromSelection ({ totalItems, std::numeric_limits<int>::max() });
+        lastRowSelected = getSelectedRow (0);
+        selectionChanged = true;
+    }
+
+    if (hoveredRow >= totalItems)
+        setHoveredRow (-1);
+
+    viewport->updateVisibleArea (isVisible());
+
+    if (previousTopRowKey.has_value())
+    {
+        const auto previousTopRow = model->getRowForKey (*previousTopRowKey);
+
+        if (juce::isPositiveAndBelow (previousTopRow, totalItems))
+        {
+            viewport->setVirtualViewY (rowHeights.getRowY (previousTopRow) + previousTopRowOffset);
+            topRowKeyRow = previousTopRow;
+        }
+    }
+
+    viewport->resized();
+
+    if (selectionChanged)
+        sendSelectionChangeMessage();
+}
+
+bool ListBox::remapSelectionToKeys()
+{
+    if (model == nullptr || selectedKeys.empty())
+        return false;
+
+    RowSelection remapped;
+    std::unordered_set<juce::int64> keysFound;
+
+    for (const auto key : selectedKeys)
+    {
+        const auto row = model->getRowForKey (key);
+
+        if (juce::isPositiveAndBelow (row, totalItems))
+        {
+            remapped.addRange ({ row, row + 1 });
+            keysFound.insert (key);
+        }
+    }
+
+    // the keys of items that have gone are forgotten
+    selectedKeys = std::move (keysFound);
+    lastRowSelected = lastSelectedKey.has_value() ? model->getRowForKey (*lastSelectedKey) : -1;
+
+    if (! remapped.contains (lastRowSelected))
+        lastRowSelected = remapped.getRow (0);
+
+    if (remapped == selected)
+        return false;
+
+    const juce::ScopedValueSetter<bool> svs (isRemappingSelection, true);
+    replaceSelection (remapped);
+    return true;
+}
+
+void ListBox::trackSelectedKeys (const RowSelection& rowsSelected, const RowSelection& rowsDeselected)
+{
+    if (model == nullptr || isRemappingSelection)
+        return;
+
+    // models without keys give up on the first row
+    for (const auto range : rowsDeselected)
+        for (auto row = range.getStart(); row < range.getEnd(); ++row)
+            if (const auto key = model->getRowKey (row))
+                selectedKeys.erase (*key);
+            else
+                return;
+
+    for (const auto range : rowsSelected)
+        for (auto row = range.getStart(); row < range.getEnd(); ++row)
+            if (const auto key = model->getRowKey (row))
+                selectedKeys.insert (*key);
+            else
+                return;
+}
+
+void ListBox::updateTopRowKey()
+{
+    // this runs once a frame rather than on every layout pass, so scrolling doesn't call the model
+    if (model == nullptr)
+        return;
+
+    if (topRow != topRowKeyRow)
+    {
+        topRowKey = topRow >= 0 ? model->getRowKey (topRow) : std::nullopt;
+        topRowKeyRow = topRow;
+    }
+
+    topRowKeyOffset = topRowOffset;
+}
+
+//==============================================================================
+static int shiftedForInsertion (const int row, const int startRow, const int numRows)
+{
+    return row >= startRow ? row + numRows : row;
+}
+
+static int shiftedForRemoval (const int row, const int startRow, const int numRows)
+{
+    if (row < startRow)
+        return row;
+
+    return row >= startRow + numRows ? row - numRows : -1;
+}
+
+/*  Moves the rows in a row-keyed map to their new positions, dropping those that map to -1. */
+template <typename ShiftFn>
+static void shiftRowKeys (std::unordered_map<int, double>& rowMap, ShiftFn&& shiftRow)
+{
+    if (rowMap.empty())
+        return;
+
+    std::unordered_map<int, double> shifted;
+    shifted.reserve (rowMap.size());
+
+    for (const auto& [row, value] : rowMap)
+        if (const auto newRow = shiftRow (row); newRow >= 0)
+            shifted.emplace (newRow, value);
+
+    rowMap = std::move (shifted);
+}
+
+void ListBox::rowsInserted (int startRow, const int numRows)
+{
+    checkModelPtrIsValid();
+
+    if (numRows <= 0)
+        return;
+
+    startRow = juce::jlimit (0, totalItems, startRow);
+    const auto anchor = getTailFollowAnchor();
+    totalItems += numRows;
+    jassert (model != nullptr && model->getNumRows() == totalItems); // call this after changing the model!
+
+    rowHeights.insertRows (startRow, numRows, getDefaultRowHeight(), [this] (juce::Range<int> rows, int* dest) { fillRowHeights (rows, dest); });
+
+    measuredRows.insertRows (startRow, numRows);
+    selected.insertRows (startRow, numRows);
+    pendingRowsSelected.insertRows (startRow, numRows);
+    pendingRowsDeselected.insertRows (startRow, numRows);
+    lastRowSelected = lastRowSelected >= 0 ? shiftedForInsertion (lastRowSelected, startRow, numRows) : -1;
+    topRowKeyRow = topRowKeyRow >= 0 ? shiftedForInsertion (topRowKeyRow, startRow, numRows) : -1;
+    shiftRowKeys (lastRowRepaintTimes, [=] (int row) { return shiftedForInsertion (row, startRow, numRows); });
+
+    if (anchor.has_value())
+        restoreTailFollowAnchor ({ anchor->wasAtBottom, shiftedForInsertion (anchor->row, startRow, numRows), anchor->offset });
+
+    // the rows above the new ones keep their place in the tiles, so appending keeps them all
+    viewport->invalidateTilesFrom (rowHeights.getRowY (startRow));
+    refreshAfterRowsChanged ({ startRow, std::numeric_limits<int>::max() }, false);
+}
+
+void ListBox::rowsRemoved (int startRow, int numRows)
+{
+    checkModelPtrIsValid();
+
+    startRow = juce::jlimit (0, totalItems, startRow);
+    numRows = juce::jlimit (0, totalItems - startRow, numRows);
+
+    if (numRows == 0)
+        return;
+
+    const auto anchor = getTailFollowAnchor();
+    totalItems -= numRows;
+    jassert (model != nullptr && model->getNumRows() == totalItems); // call this after changing the model!
+
+    // rows evicted from the start leave the others where they were in the tiles
+    if (startRow == 0)
+        viewport->firstRowsRemoved (numRows, rowHeights.getRowY (numRows));
+    else
+        viewport->invalidateTilesFrom (rowHeights.getRowY (startRow));
+
+    rowHeights.removeRows (startRow, numRows);
+    measuredRows.removeRows (startRow, numRows);
+
+    const auto selectionChanged = selected.overlapsRange (juce::Range<int>::withStartAndLength (startRow, numRows));
+    selected.removeRows (startRow, numRows);
+    pendingRowsSelected.removeRows (startRow, numRows);
+    pendingRowsDeselected.removeRows (startRow, numRows);
+    lastRowSelected = shiftedForRemoval (lastRowSelected, startRow, numRows);
+    if (topRowKeyRow >= 0)
+    {
+        topRowKeyRow = shiftedForRemoval (topRowKeyRow, startRow, numRows);
+
+        if (topRowKeyRow < 0)
+            topRowKey.reset();
+    }
+    shiftRowKeys (lastRowRepaintTimes, [=] (int row) { return shiftedForRemoval (row, startRow, numRows); });
+
+    if (! isRowSelected (lastRowSelected))
+        lastRowSelected = getSelectedRow (0);
+
+    // the keys of the removed rows can't be looked up any more
+    if (selectionChanged)
+    {
+        selectedKeys.clear();
+        trackSelectedKeys (selected, {});
+    }
+
+    if (anchor.has_value())
+    {
+        const auto anchorRow = shiftedForRemoval (anchor->row, startRow, numRows);
+
+        // if the anchor row itself was removed, the view moves to the first row after it
+        restoreTailFollowAnchor (anchorRow >= 0 ? TailFollowAnchor { anchor->wasAtBottom, anchorRow, anchor->offset }
+                                                : TailFollowAnchor { anchor->wasAtBottom, startRow, 0 });
+    }
+
+    refreshAfterRowsChanged ({ startRow, std::numeric_limits<int>::max() }, selectionChanged);
+}
+
+void ListBox::rowsMoved (const int startRow, const int numRows, const int newStartRow)
+{
+    checkModelPtrIsValid();
+
+    if (numRows <= 0 || startRow == newStartRow)
+        return;
+
+    jassert (startRow >= 0 && startRow + numRows <= totalItems);
+    jassert (juce::isPositiveAndNotGreaterThan (newStartRow, totalItems - numRows));
+
+    rowHeights.moveRows (startRow, numRows, newStartRow);
+    measuredRows.moveRows (startRow, numRows, newStartRow);
+    selected.moveRows (startRow, numRows, newStartRow);
+    pendingRowsSelected.moveRows (startRow, numRows, newStartRow);
+    pendingRowsDeselected.moveRows (startRow, numRows, newStartRow);
+
+    if (juce::Range<int>::withStartAndLength (startRow, numRows).contains (lastRowSelected))
+        lastRowSelected += newStartRow - startRow;
+    else if (lastRowSelected >= 0)
+        lastRowSelected = shiftedForInsertion (shiftedForRemoval (lastRowSelected, startRow, numRows), newStartRow, numRows);
+
+    // the key still names the same item, but which row is on top gets checked again next frame
+    topRowKeyRow = -1;
+
+    shiftRowKeys (lastRowRepaintTimes, [=] (int row)
+    {
+        if (juce::Range<int>::withStartAndLength (startRow, numRows).contains (row))
+            return row + newStartRow - startRow;
+
+        return shiftedForInsertion (shiftedForRemoval (row, startRow, numRows), newStartRow, numRows);
+    });
+
+    const juce::Range<int> movedRows { juce::jmin (startRow, newStartRow), juce::jmax (startRow, newStartRow) + numRows };
+    viewport->invalidateTiles (movedRows);
+    refreshAfterRowsChanged (movedRows, false);
+}
+
+void ListBox::rowsChanged (const juce::Range<int> rows)
+{
+    checkModelPtrIsValid();
+
+    const auto range = rows.getIntersectionWith ({ 0, totalItems });
+
+    // with estimated heights, the rows that are on-screen get measured again when refreshed
+    if (isEstimatingRowHeights())
+        measuredRows.removeRange (range);
+    else
+        for (auto row = range.getStart(); row < range.getEnd(); ++row)
+            updateRowHeightFromModel (row);
+
+    viewport->invalidateTiles (range);
+    refreshAfterRowsChanged (range, false);
+}
+
+void ListBox::rowsBecameReady (const juce::SparseSet<int>& rows)
+{
+    {
+        const juce::SpinLock::ScopedLockType sl (pendingReadyRowsLock);
+
+        for (auto i = 0; i < rows.getNumRanges(); ++i)
+            pendingReadyRows.addRange (rows.getRange (i));
+    }
+
+    hasPendingReadyRows = true;
+}
+
+void ListBox::updateContentAsync()
+{
+    {
+        const juce::SpinLock::ScopedLockType sl (pendingChangesLock);
+        needsAsyncContentUpdate = true;
+    }
+
+    hasPendingChanges = true;
+}
+
+void ListBox::rowsChangedAsync (const juce::Range<int> rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    {
+        const juce::SpinLock::ScopedLockType sl (pendingChangesLock);
+        pendingChangedRows.addRange (rows);
+    }
+
+    hasPendingChanges = true;
 }
 
-void ListBox::paintOverChildren (juce::Graphics& g)
+void ListBox::applyPendingChanges()
 {
-    if (outlineThickness > 0)
+    juce::SparseSet<int> changedRows;
+    bool needsContentUpdate;
+
     {
-        g.setColour (findColour (outlineColourId));
-        g.drawRect (getLocalBounds(), outlineThickness);
+        const juce::SpinLock::ScopedLockType sl (pendingChangesLock);
+        std::swap (changedRows, pendingChangedRows);
+        needsContentUpdate = std::exchange (needsAsyncContentUpdate, false);
     }
-}
 
-void ListBox::resized()
-{
-    viewport->setBoundsInset (juce::BorderSize<int> (outlineThickness + (headerComponent != nullptr ? headerComponent->getHeight() : 0),
-                                                     outlineThickness,
-                                                     outlineThickness,
-                                                     outlineThickness));
+    if (needsContentUpdate || totalItems != (model != nullptr ? model->getNumRows() : 0))
+    {
+        updateContent();
+        return;
+    }
 
-    viewport->setSingleStepSizes (20, getDefaultRowHeight());
+    // like rowsChanged() for each range, but with one relayout for all of them
+    for (auto i = 0; i < changedRows.getNumRanges(); ++i)
+    {
+        const auto range = changedRows.getRange (i).getIntersectionWith ({ 0, totalItems });
+
+        if (isEstimatingRowHeights())
+            measuredRows.removeRange (range);
+        else
+            for (auto row = range.getStart(); row < range.getEnd(); ++row)
+                updateRowHeightFromModel (row);
+
+        if (rowImageCache != nullptr)
+            rowImageCache->removeIf ([range] (const RowImageCache::Key& key) { return range.contains (key.row); });
+    }
 
     viewport->updateVisibleArea (false);
+    viewport->updateContents();
+    viewport->refreshAndRepaintRows (changedRows);
 }
 
-void ListBox::visibilityChanged()
+void ListBox::handleFrameUpdate()
 {
-    viewport->updateVisibleArea (true);
-}
+    checkModelPtrIsValid();
 
-juce::Viewport* ListBox::getViewport() const noexcept
-{
-    return viewport.get();
+    updateTopRowKey();
+
+    if (model != nullptr)
+        model->listBoxFrameUpdate (*this);
+
+    if (hasPendingChanges.exchange (false))
+        applyPendingChanges();
+
+    if (hasPendingReadyRows.exchange (false))
+    {
+        juce::SparseSet<int> readyRows;
+
+        {
+            const juce::SpinLock::ScopedLockType sl (pendingReadyRowsLock);
+            std::swap (readyRows, pendingReadyRows);
+        }
+
+        viewport->refreshAndRepaintRows (readyRows);
+    }
+
+    if (hasDirtyRows.exchange (false))
+        repaintDirtyRows();
 }
 
-//==============================================================================
-void ListBox::updateContent()
+void ListBox::repaintDirtyRows()
 {
-    checkModelPtrIsValid();
-    hasDoneInitialUpdate = true;
-    totalItems = (model != nullptr) ? model->getNumRows() : 0;
+    juce::SparseSet<int> rowsToRepaint, rowsToDelay;
 
-    if (model != nullptr)
     {
-        // update item height sums
-        itemHeightSum.clear();
-        auto sumToRow = 0;
-        for (auto i = 0; i < totalItems; i++)
+        const juce::SpinLock::ScopedLockType sl (dirtyRowsLock);
+        std::swap (rowsToRepaint, dirtyRows);
+    }
+
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+    const auto interval = (double) minimumRowRepaintInterval;
+
+    // rows that were repainted too recently wait for a later frame
+    for (auto iter = lastRowRepaintTimes.begin(); iter != lastRowRepaintTimes.end();)
+    {
+        if (now - iter->second >= interval)
+        {
+            iter = lastRowRepaintTimes.erase (iter);
+            continue;
+        }
+
+        if (rowsToRepaint.contains (iter->first))
         {
-            jassert (i < totalItems);
-            sumToRow += getRowHeight (i);
-            itemHeightSum.push_back (sumToRow);
+            const auto row = juce::Range<int>::withStartAndLength (iter->first, 1);
+            rowsToRepaint.removeRange (row);
+            rowsToDelay.addRange (row);
         }
+
+        ++iter;
     }
 
-    bool selectionChanged = false;
+    const auto visibleRows = viewport->getVisibleRows();
+
+    if (rowImageCache != nullptr && ! rowsToRepaint.isEmpty())
+        rowImageCache->removeIf ([&rowsToRepaint] (const RowImageCache::Key& key) { return rowsToRepaint.contains (key.row); });
 
-    if (selected.size() > 0 && selected[selected.size() - 1] >= totalItems)
+    for (auto i = 0; i < rowsToRepaint.getNumRanges(); ++i)
     {
-        selected.removeRange ({ totalItems, std::numeric_limits<int>::max() });
-        lastRowSelected = getSelectedRow (0);
-        selectionChanged = true;
+        const auto range = rowsToRepaint.getRange (i);
+        viewport->invalidateTiles (range);
+
+        // rows that aren't on-screen get painted anyway once they scroll into view
+        const auto visibleRange = range.getIntersectionWith (visibleRows);
+        viewport->repaintRows (visibleRange);
+
+        if (interval > 0.0)
+            for (auto row = visibleRange.getStart(); row < visibleRange.getEnd(); ++row)
+                lastRowRepaintTimes[row] = now;
     }
 
-    viewport->updateVisibleArea (isVisible());
-    viewport->resized();
+    if (rowsToDelay.isEmpty())
+        return;
 
-    if (selectionChanged)
     {
-        if (model != nullptr)
-            model->selectedRowsChanged (lastRowSelected);
-        if (auto* handler = getAccessibilityHandler())
-            handler->notifyAccessibilityEvent (juce::AccessibilityEvent::rowSelectionChanged);
+        const juce::SpinLock::ScopedLockType sl (dirtyRowsLock);
+
+        for (auto i = 0; i < rowsToDelay.getNumRanges(); ++i)
+            dirtyRows.addRange (rowsToDelay.getRange (i));
     }
+
+    hasDirtyRows = true;
+}
+
+void ListBox::refreshAfterRowsChanged (const juce::Range<int> rowsToRefresh, const bool selectionChanged)
+{
+    if (rowImageCache != nullptr)
+        rowImageCache->removeIf ([rowsToRefresh] (const RowImageCache::Key& key) { return rowsToRefresh.contains (key.row); });
+
+    viewport->updateVisibleArea (false);
+    viewport->updateContents (rowsToRefresh);
+
+    if (selectionChanged)
+        sendSelectionChangeMessage();
 }
 
 //==============================================================================
@@ -741,20 +2201,28 @@ void ListBox::selectRowInternal (const int row,
         if (juce::isPositiveAndBelow (row, totalItems))
         {
             if (deselectOthersFirst)
-                selected.clear();
+                replaceSelection ({});
 
-            selected.addRange ({ row, row + 1 });
+            addToSelection ({ row, row + 1 });
 
             if (getHeight() == 0 || getWidth() == 0)
                 dontScroll = true;
 
-            viewport->selectRow (row, getRowHeight (row), dontScroll, lastRowSelected, totalItems, isMouseClick);
+            if (selectionChangeDepth > 0)
+            {
+                // the scrolling waits for endSelectionChange(), and then goes to the last row selected
+                if (! dontScroll)
+                    deferredScroll = { row, isMouseClick };
 
-            lastRowSelected = row;
-            model->selectedRowsChanged (row);
+                selectionNeedsContentUpdate = true;
+            }
+            else
+            {
+                viewport->selectRow (row, getRowHeight (row), dontScroll, lastRowSelected, totalItems, isMouseClick);
+            }
 
-            if (auto* handler = getAccessibilityHandler())
-                handler->notifyAccessibilityEvent (juce::AccessibilityEvent::rowSelectionChanged);
+            lastRowSelected = row;
+            sendSelectionChangeMessage();
         }
         else
         {
@@ -770,16 +2238,13 @@ void ListBox::deselectRow (const int row)
 
     if (selected.contains (row))
     {
-        selected.removeRange ({ row, row + 1 });
+        removeFromSelection ({ row, row + 1 });
 
         if (row == lastRowSelected)
             lastRowSelected = getSelectedRow (0);
 
-        viewport->updateContents();
-        model->selectedRowsChanged (lastRowSelected);
-
-        if (auto* handler = getAccessibilityHandler())
-            handler->notifyAccessibilityEvent (juce::AccessibilityEvent::rowSelectionChanged);
+        updateContentsForSelection();
+        sendSelectionChangeMessage();
     }
 }
 
@@ -788,24 +2253,26 @@ void ListBox::setSelectedRows (const juce::SparseSet<int>& setOfRowsToBeSelected
 {
     checkModelPtrIsValid();
 
-    selected = setOfRowsToBeSelected;
-    selected.removeRange ({ totalItems, std::numeric_limits<int>::max() });
+    RowSelection newSelection (setOfRowsToBeSelected);
+    newSelection.removeRange ({ totalItems, std::numeric_limits<int>::max() });
+    replaceSelection (newSelection);
 
     if (! isRowSelected (lastRowSelected))
         lastRowSelected = getSelectedRow (0);
 
-    viewport->updateContents();
-
-    if (model != nullptr && sendNotificationEventToModel == juce::sendNotification)
-        model->selectedRowsChanged (lastRowSelected);
-
-    if (auto* handler = getAccessibilityHandler())
-        handler->notifyAccessibilityEvent (juce::AccessibilityEvent::rowSelectionChanged);
+    updateContentsForSelection();
+    sendSelectionChangeMessage (sendNotificationEventToModel);
 }
 
 juce::SparseSet<int> ListBox::getSelectedRows() const
 {
-    return selected;
+    if (selectedRowSetRevision != selected.getRevision())
+    {
+        selectedRowSet = selected.toSparseSet();
+        selectedRowSetRevision = selected.getRevision();
+    }
+
+    return selectedRowSet;
 }
 
 void ListBox::selectRangeOfRows (int firstRow, int lastRow, bool dontScrollToShowThisRange)
@@ -816,10 +2283,10 @@ void ListBox::selectRangeOfRows (int firstRow, int lastRow, bool dontScrollToSho
         firstRow = juce::jlimit (0, std::max<int> (0, numRows), firstRow);
         lastRow = juce::jlimit (0, std::max<int> (0, numRows), lastRow);
 
-        selected.addRange ({ std::min<int> (firstRow, lastRow),
-                             std::max<int> (firstRow, lastRow) + 1 });
+        addToSelection ({ std::min<int> (firstRow, lastRow),
+                          std::max<int> (firstRow, lastRow) + 1 });
 
-        selected.removeRange ({ lastRow, lastRow + 1 });
+        removeFromSelection ({ lastRow, lastRow + 1 });
     }
 
     selectRowInternal (lastRow, dontScrollToShowThisRange, false, true);
@@ -839,17 +2306,119 @@ void ListBox::deselectAllRows()
 
     if (! selected.isEmpty())
     {
-        selected.clear();
+        replaceSelection ({});
         lastRowSelected = -1;
 
+        updateContentsForSelection();
+        sendSelectionChangeMessage();
+    }
+}
+
+void ListBox::addToSelection (const juce::Range<int> rows)
+{
+    RowSelection rowsToAdd;
+    rowsToAdd.addRange (rows);
+
+    recordSelectionChange (rowsToAdd.withoutRowsIn (selected), {});
+    selected.addRange (rows);
+}
+
+void ListBox::removeFromSelection (const juce::Range<int> rows)
+{
+    recordSelectionChange ({}, selected.getRowsIn (rows));
+    selected.removeRange (rows);
+}
+
+void ListBox::replaceSelection (const RowSelection& newSelection)
+{
+    recordSelectionChange (newSelection.withoutRowsIn (selected), selected.withoutRowsIn (newSelection));
+    selected = newSelection;
+}
+
+void ListBox::recordSelectionChange (const RowSelection& rowsSelected, const RowSelection& rowsDeselected)
+{
+    trackSelectedKeys (rowsSelected, rowsDeselected);
+
+    // a row that gets deselected and then selected again (or vice-versa) cancels out.
+    // This is done in place, so each change costs O(log R) in the pending ranges.
+    const auto addPendingChange = [] (const RowSelection& changedRows, RowSelection& pending, RowSelection& pendingOpposite)
+    {
+        for (const auto rows : changedRows)
+        {
+            const auto cancelled = pendingOpposite.getRowsIn (rows);
+
+            pendingOpposite.removeRange (rows);
+            pending.addRange (rows);
+
+            for (const auto cancelledRows : cancelled)
+                pending.removeRange (cancelledRows);
+        }
+    };
+
+    addPendingChange (rowsSelected, pendingRowsSelected, pendingRowsDeselected);
+    addPendingChange (rowsDeselected, pendingRowsDeselected, pendingRowsSelected);
+}
+
+void ListBox::beginSelectionChange()
+{
+    if (selectionChangeDepth++ == 0)
+        lastRowSelectedBeforeChange = lastRowSelected;
+}
+
+void ListBox::endSelectionChange()
+{
+    jassert (selectionChangeDepth > 0); // unbalanced call!
+
+    if (selectionChangeDepth == 0 || --selectionChangeDepth > 0)
+        return;
+
+    if (deferredScroll.has_value() && juce::isPositiveAndBelow (deferredScroll->row, totalItems))
+        viewport->selectRow (deferredScroll->row, getRowHeight (deferredScroll->row), false,
+                             lastRowSelectedBeforeChange, totalItems, deferredScroll->isMouseClick);
+    else if (selectionNeedsContentUpdate)
         viewport->updateContents();
 
-        if (model != nullptr)
-            model->selectedRowsChanged (lastRowSelected);
+    deferredScroll.reset();
+    selectionNeedsContentUpdate = false;
+
+    if (std::exchange (hasDeferredSelectionMessage, false))
+        sendSelectionChangeMessage (std::exchange (deferredMessageNotifiesModel, false) ? juce::sendNotification
+                                                                                         : juce::dontSendNotification);
+}
+
+void ListBox::updateContentsForSelection()
+{
+    if (selectionChangeDepth > 0)
+        selectionNeedsContentUpdate = true;
+    else
+        viewport->updateContents();
+}
+
+void ListBox::sendSelectionChangeMessage (const juce::NotificationType notification)
+{
+    if (selectionChangeDepth > 0)
+    {
+        hasDeferredSelectionMessage = true;
+        deferredMessageNotifiesModel = deferredMessageNotifiesModel || notification == juce::sendNotification;
+        return;
+    }
+
+    RowSelection rowsSelected, rowsDeselected;
+    std::swap (rowsSelected, pendingRowsSelected);
+    std::swap (rowsDeselected, pendingRowsDeselected);
+
+    lastSelectedKey = model != nullptr && lastRowSelected >= 0 ? model->getRowKey (lastRowSelected) : std::nullopt;
 
-        if (auto* handler = getAccessibilityHandler())
-            handler->notifyAccessibilityEvent (juce::AccessibilityEvent::rowSelectionChanged);
+    if (model != nullptr && notification == juce::sendNotification)
+    {
+        if (! (rowsSelected.isEmpty() && rowsDeselected.isEmpty()))
+            model->selectedRowRangesChanged (rowsSelected, rowsDeselected);
+
+        model->selectedRowsChanged (lastRowSelected);
     }
+
+    if (auto* handler = getAccessibilityHandler())
+        handler->notifyAccessibilityEvent (juce::AccessibilityEvent::rowSelectionChanged);
 }
 
 void ListBox::selectRowsBasedOnModifierKeys (const int row,
@@ -877,9 +2446,7 @@ int ListBox::getNumSelectedRows() const
 
 int ListBox::getSelectedRow (const int index) const
 {
-    return (juce::isPositiveAndBelow (index, selected.size()))
-               ? selected[index]
-               : -1;
+    return selected.getRow (index);
 }
 
 bool ListBox::isRowSelected (const int row) const
@@ -897,10 +2464,9 @@ int ListBox::getRowContainingPosition (const int x, const int y) const noexcept
 {
     if (juce::isPositiveAndBelow (x, getWidth()))
     {
-        const auto absoluteY = viewport->getViewPositionY() + y;
-        const auto row = *std::lower_bound (itemHeightSum.begin(), itemHeightSum.end(), absoluteY);
+        const auto row = rowHeights.getRowContaining (viewport->getVirtualViewY() + y - viewport->getY());
 
-        if (juce::isPositiveAndBelow (row, itemHeightSum.back()))
+        if (juce::isPositiveAndBelow (row, totalItems))
             return row;
     }
 
@@ -910,7 +2476,16 @@ int ListBox::getRowContainingPosition (const int x, const int y) const noexcept
 int ListBox::getInsertionIndexForPosition (const int x, const int y) const noexcept
 {
     if (juce::isPositiveAndBelow (x, getWidth()))
-        return juce::jlimit (0, totalItems, (viewport->getViewPositionY() + y + rowHeight / 2 - viewport->getY()) / rowHeight);
+    {
+        const auto absoluteY = viewport->getVirtualViewY() + y - viewport->getY();
+        const auto row = rowHeights.getRowContaining (absoluteY);
+
+        if (! juce::isPositiveAndBelow (row, totalItems))
+            return row < 0 ? 0 : totalItems;
+
+        // past the middle of a row means inserting after it
+        return absoluteY - rowHeights.getRowY (row) >= rowHeights.getHeight (row) / 2 ? row + 1 : row;
+    }
 
     return -1;
 }
@@ -930,27 +2505,29 @@ int ListBox::getRowNumberOfComponent (const juce::Component* const rowComponent)
 
 juce::Rectangle<int> ListBox::getRowPosition (int rowNumber, bool relativeToComponentTopLeft) const noexcept
 {
-    auto y = viewport->getY() + rowHeight * rowNumber;
+    const auto rowY = viewport->getRowY (rowNumber);
+    auto y = viewport->getY();
 
     if (relativeToComponentTopLeft)
-        y -= viewport->getViewPositionY();
+        y += (int) juce::jlimit<juce::int64> (-ListViewport::maxContentHeight, ListViewport::maxContentHeight, rowY - viewport->getVirtualViewY());
+    else
+        y += viewport->toContentY (rowY);
 
-    return { viewport->getX(), y, viewport->getViewedComponent()->getWidth(), rowHeight };
+    return { viewport->getX(), y, viewport->getViewedComponent()->getWidth(), getRowHeight (rowNumber) };
 }
 
 void ListBox::setVerticalPosition (const double proportion)
 {
-    auto offscreen = viewport->getViewedComponent()->getHeight() - viewport->getHeight();
+    const auto offscreen = viewport->getMaxVirtualViewY();
 
-    viewport->setViewPosition (viewport->getViewPositionX(),
-                               std::max<int> (0, juce::roundToInt (proportion * offscreen)));
+    viewport->setVirtualViewY (juce::jmax<juce::int64> (0, (juce::int64) std::llround (proportion * (double) offscreen)));
 }
 
 double ListBox::getVerticalPosition() const
 {
-    auto offscreen = viewport->getViewedComponent()->getHeight() - viewport->getHeight();
+    const auto offscreen = viewport->getMaxVirtualViewY();
 
-    return offscreen > 0 ? viewport->getViewPositionY() / (double) offscreen
+    return offscreen > 0 ? (double) viewport->getVirtualViewY() / (double) offscreen
                          : 0;
 }
 
@@ -970,6 +2547,12 @@ bool ListBox::keyPressed (const juce::KeyPress& key)
     checkModelPtrIsValid();
     //    const int numVisibleRows = 0; //viewport->getHeight() / getRowHeight();
 
+    if (model != nullptr && juce::isPositiveAndBelow (lastRowSelected, totalItems) && model->rowKeyPressed (lastRowSelected, key))
+    {
+        repaintRow (lastRowSelected);
+        return true;
+    }
+
     const bool multiple = multipleSelection
                           && lastRowSelected >= 0
                           && key.getModifiers().isShiftDown();
@@ -1081,6 +2664,14 @@ int ListBox::getDefaultRowHeight() const noexcept
 }
 
 int ListBox::getRowHeight (const int rowNumber) const noexcept
+{
+    if (juce::isPositiveAndBelow (rowNumber, rowHeights.size()))
+        return rowHeights.getHeight (rowNumber);
+
+    return getDefaultRowHeight();
+}
+
+int ListBox::getRowHeightFromModel (const int rowNumber) const
 {
     if (model == nullptr || rowNumber >= totalItems)
         return getDefaultRowHeight();
@@ -1089,12 +2680,135 @@ int ListBox::getRowHeight (const int rowNumber) const noexcept
     return heightForRow > 0 ? heightForRow : getDefaultRowHeight();
 }
 
+void ListBox::updateRowHeightFromModel (const int rowNumber)
+{
+    const auto newHeight = getRowHeightFromModel (rowNumber);
+
+    if (newHeight == rowHeights.getHeight (rowNumber))
+        return;
+
+    rowHeights.setHeight (rowNumber, newHeight);
+
+    // every row below this one has moved within the tiles
+    viewport->invalidateTilesFrom (rowHeights.getRowY (rowNumber));
+}
+
+void ListBox::fillRowHeights (const juce::Range<int> rows, int* dest) const
+{
+    // the index replaces non-positive heights with the default one
+    if (isEstimatingRowHeights())
+        std::fill_n (dest, rows.getLength(), estimatedRowHeight);
+    else if (model == nullptr)
+        std::fill_n (dest, rows.getLength(), 0);
+    else if (! model->getRowHeights (rows, dest))
+        for (auto row = rows.getStart(); row < rows.getEnd(); ++row)
+            *dest++ = model->getRowHeight (row);
+}
+
+bool ListBox::measureRows (const juce::Range<int> rows)
+{
+    if (! isEstimatingRowHeights())
+        return false;
+
+    const auto range = rows.getIntersectionWith ({ 0, totalItems });
+
+    if (range.isEmpty() || measuredRows.countInRange (range) == range.getLength())
+        return false;
+
+    for (auto row = range.getStart(); row < range.getEnd(); ++row)
+        if (! measuredRows.contains (row))
+            updateRowHeightFromModel (row);
+
+    measuredRows.addRange (range);
+    return true;
+}
+
 int ListBox::getNumRowsOnScreen() const noexcept
 {
-    const auto* vp = getViewport();
-    const auto firstVisibleRowIndex = std::lower_bound (itemHeightSum.begin(), itemHeightSum.end(), vp->getViewPositionY()) - itemHeightSum.begin();
-    const auto lastVisibleRowIndex = std::lower_bound (itemHeightSum.begin(), itemHeightSum.end(), vp->getViewPositionY() + vp->getViewHeight()) - itemHeightSum.begin();
-    return static_cast<int> (lastVisibleRowIndex - firstVisibleRowIndex);
+    const auto* vp = viewport.get();
+    const auto firstVisibleRowIndex = rowHeights.getRowContaining (vp->getVirtualViewY());
+    const auto lastVisibleRowIndex = rowHeights.getRowContaining (vp->getVirtualViewY() + vp->getViewHeight());
+    return lastVisibleRowIndex - firstVisibleRowIndex;
+}
+
+void ListBox::setRowImageCacheSize (const size_t maxBytes)
+{
+    if (maxBytes == getRowImageCacheSize())
+        return;
+
+    rowImageCache = maxBytes > 0 ? std::make_unique<RowImageCache> (maxBytes) : nullptr;
+    viewport->repaint();
+}
+
+size_t ListBox::getRowImageCacheSize() const noexcept
+{
+    return rowImageCache != nullptr ? rowImageCache->getMaxBytes() : 0;
+}
+
+void ListBox::setScrollCacheEnabled (const bool shouldBeEnabled)
+{
+    if (scrollCacheEnabled == shouldBeEnabled)
+        return;
+
+    scrollCacheEnabled = shouldBeEnabled;
+    viewport->clearTiles();
+    viewport->repaint();
+}
+
+void ListBox::setDirectPaintEnabled (const bool shouldPaintDirectly)
+{
+    if (directPaintEnabled == shouldPaintDirectly)
+        return;
+
+    directPaintEnabled = shouldPaintDirectly;
+    viewport->refreshAllRows();
+    viewport->updateContents();
+    viewport->repaint();
+}
+
+void ListBox::setOverscan (const int numPixels)
+{
+    overscanPixels = std::max (0, numPixels);
+    viewport->updateContents();
+}
+
+int ListBox::getOverscan() const noexcept
+{
+    return overscanPixels;
+}
+
+void ListBox::setTailFollowEnabled (const bool shouldFollowTail)
+{
+    tailFollowEnabled = shouldFollowTail;
+
+    if (shouldFollowTail)
+        viewport->setVirtualViewY (viewport->getMaxVirtualViewY());
+}
+
+/*  Where the view is, taken before rows are inserted or removed in tail-follow mode. */
+std::optional<ListBox::TailFollowAnchor> ListBox::getTailFollowAnchor() const
+{
+    if (! tailFollowEnabled)
+        return {};
+
+    const auto viewY = viewport->getVirtualViewY();
+    const auto row = juce::jlimit (0, juce::jmax (0, totalItems - 1), rowHeights.getRowContaining (viewY));
+
+    // a pixel of slack, so that a fractional scroll position still counts as the bottom
+    return TailFollowAnchor { viewY >= viewport->getMaxVirtualViewY() - 1,
+                              row,
+                              totalItems > 0 ? viewY - rowHeights.getRowY (row) : 0 };
+}
+
+/*  Scrolls back to the bottom, or to the anchor's row, which the caller has shifted. */
+void ListBox::restoreTailFollowAnchor (const TailFollowAnchor& anchor)
+{
+    viewport->updateVisibleArea (false);
+
+    if (anchor.wasAtBottom)
+        viewport->setVirtualViewY (viewport->getMaxVirtualViewY());
+    else if (juce::isPositiveAndBelow (anchor.row, totalItems))
+        viewport->setVirtualViewY (rowHeights.getRowY (anchor.row) + anchor.offset);
 }
 
 void ListBox::setMinimumContentWidth (const int newMinimumWidth)
@@ -1112,6 +2826,7 @@ void ListBox::colourChanged()
 {
     setOpaque (findColour (backgroundColourId).isOpaque());
     viewport->setOpaque (isOpaque());
+    viewport->clearTiles();
     repaint();
 }
 
@@ -1142,7 +2857,37 @@ bool ListBox::hasAccessibleHeaderComponent() const
 
 void ListBox::repaintRow (const int rowNumber) noexcept
 {
-    repaint (getRowPosition (rowNumber, true));
+    if (rowImageCache != nullptr)
+        rowImageCache->removeIf ([rowNumber] (const RowImageCache::Key& key) { return key.row == rowNumber; });
+
+    viewport->invalidateTiles ({ rowNumber, rowNumber + 1 });
+    viewport->repaintRows ({ rowNumber, rowNumber + 1 });
+}
+
+void ListBox::markRowDirty (const int rowNumber)
+{
+    if (rowNumber < 0)
+        return;
+
+    {
+        const juce::SpinLock::ScopedLockType sl (dirtyRowsLock);
+        dirtyRows.addRange ({ rowNumber, rowNumber + 1 });
+    }
+
+    hasDirtyRows = true;
+}
+
+void ListBox::setMinimumRowRepaintInterval (const int milliseconds)
+{
+    minimumRowRepaintInterval = juce::jmax (0, milliseconds);
+
+    if (minimumRowRepaintInterval == 0)
+        lastRowRepaintTimes.clear();
+}
+
+int ListBox::getMinimumRowRepaintInterval() const noexcept
+{
+    return minimumRowRepaintInterval;
 }
 
 juce::ScaledImage ListBox::createSnapshotOfRows (const juce::SparseSet<int>& rows, int& imageX, int& imageY)
@@ -1154,7 +2899,11 @@ juce::ScaledImage ListBox::createSnapshotOfRows (const juce::SparseSet<int>& row
     {
         if (rows.contains (firstRow + i))
         {
-            if (auto* rowComp = viewport->getComponentForRowIfOnscreen (firstRow + i))
+            if (directPaintEnabled && juce::isPositiveAndBelow (firstRow + i, totalItems))
+            {
+                imageArea = imageArea.getUnion (getRowPosition (firstRow + i, true));
+            }
+            else if (auto* rowComp = viewport->getComponentForRowIfOnscreen (firstRow + i))
             {
                 auto pos = getLocalPoint (rowComp, juce::Point<int>());
 
@@ -1167,6 +2916,9 @@ juce::ScaledImage ListBox::createSnapshotOfRows (const juce::SparseSet<int>& row
     imageX = imageArea.getX();
     imageY = imageArea.getY();
 
+    // the rows only paint themselves when the scroll cache isn't doing it for them
+    const juce::ScopedValueSetter<bool> svs (scrollCacheEnabled, false);
+
     const auto additionalScale = 2.0f;
     const auto listScale = Component::getApproximateScaleFactorForComponent (this) * additionalScale;
     juce::Image snapshot (juce::Image::ARGB,
@@ -1178,7 +2930,24 @@ juce::ScaledImage ListBox::createSnapshotOfRows (const juce::SparseSet<int>& row
     {
         if (rows.contains (firstRow + i))
         {
-            if (auto* rowComp = viewport->getComponentForRowIfOnscreen (firstRow + i))
+            if (directPaintEnabled && model != nullptr && juce::isPositiveAndBelow (firstRow + i, totalItems))
+            {
+                const auto rowArea = getRowPosition (firstRow + i, true);
+
+                juce::Graphics g (snapshot);
+                g.setOrigin ((rowArea.getPosition() - imageArea.getPosition()) * additionalScale);
+
+                const auto rowScale = juce::Component::getApproximateScaleFactorForComponent (this) * additionalScale;
+
+                if (g.reduceClipRegion (rowArea.withZeroOrigin() * rowScale))
+                {
+                    g.beginTransparencyLayer (0.6f);
+                    g.addTransform (juce::AffineTransform::scale (rowScale));
+                    model->paintListBoxItem (firstRow + i, g, rowArea.getWidth(), rowArea.getHeight(), isRowSelected (firstRow + i));
+                    g.endTransparencyLayer();
+                }
+            }
+            else if (auto* rowComp = viewport->getComponentForRowIfOnscreen (firstRow + i))
             {
                 juce::Graphics g (snapshot);
                 g.setOrigin ((getLocalPoint (rowComp, juce::Point<int>()) - imageArea.getPosition()) * additionalScale);
@@ -1250,6 +3019,10 @@ std::unique_ptr<juce::AccessibilityHandler> ListBox::createAccessibilityHandler(
 
         const juce::AccessibilityHandler* getRowHandler (int row) const override
         {
+            // in direct paint mode, the row components only appear once a client is asking
+            if (listBox.directPaintEnabled && listBox.viewport->getComponentForRowIfOnscreen (row) == nullptr)
+                listBox.viewport->updateContents();
+
             if (auto* rowComponent = listBox.viewport->getComponentForRowIfOnscreen (row))
                 return rowComponent->getAccessibilityHandler();
 
@@ -1304,14 +3077,48 @@ int ListBoxModel::getRowHeight (int /*rowNumber*/) const
     return -1;
 }
 
+int ListBoxModel::getEstimatedRowHeight() const
+{
+    return -1;
+}
+
+bool ListBoxModel::getRowHeights (juce::Range<int>, int*) const
+{
+    return false;
+}
+
+bool ListBoxModel::hasUniformRowHeights() const
+{
+    return false;
+}
+
+int ListBoxModel::getRowTypeId (int) { return 0; }
 juce::String ListBoxModel::getNameForRow (int rowNumber)                      { return "Row " + juce::String (rowNumber + 1); }
 void ListBoxModel::listBoxItemClicked (int, const juce::MouseEvent&) {}
 void ListBoxModel::listBoxItemDoubleClicked (int, const juce::MouseEvent&) {}
 void ListBoxModel::backgroundClicked (const juce::MouseEvent&) {}
+bool ListBoxModel::rowMouseDown (int, int, int, const juce::MouseEvent&) { return false; }
+void ListBoxModel::rowMouseDrag (int, int, int, const juce::MouseEvent&) {}
+void ListBoxModel::rowMouseUp (int, int, int, const juce::MouseEvent&) {}
+bool ListBoxModel::rowKeyPressed (int, const juce::KeyPress&) { return false; }
 void ListBoxModel::selectedRowsChanged (int) {}
+void ListBoxModel::selectedRowRangesChanged (const RowSelection&, const RowSelection&) {}
 void ListBoxModel::deleteKeyPressed (int) {}
 void ListBoxModel::returnKeyPressed (int) {}
 void ListBoxModel::listWasScrolled() {}
+void ListBoxModel::hoveredRowChanged (int) {}
+void ListBoxModel::prefetchRows (juce::Range<int>) {}
+void ListBoxModel::listBoxFrameUpdate (ListBox&) {}
+bool ListBoxModel::isRowReady (int) { return true; }
+juce::int64 ListBoxModel::getRowContentVersion (int) { return 0; }
+std::optional<juce::int64> ListBoxModel::getRowKey (int) { return {}; }
+int ListBoxModel::getRowForKey (juce::int64) { return -1; }
+
+void ListBoxModel::paintRowPlaceholder (int, juce::Graphics& g, int width, int height, bool)
+{
+    g.setColour (juce::Colours::grey.withAlpha (0.2f));
+    g.fillRect (juce::Rectangle<int> (width, height).reduced (juce::jmin (8, width / 4), height / 3));
+}
 juce::var ListBoxModel::getDragSourceDescription (const juce::SparseSet<int>&) { return {}; }
 juce::String ListBoxModel::getTooltipForRow (int) { return {}; }
 juce::MouseCursor ListBoxModel::getMouseCursorForRow (int) { return juce::MouseCursor::NormalCursor; }
@@ -30,6 +30,9 @@
 
 #include <juce_gui_basics/juce_gui_basics.h>
 
+#include "RowHeightIndex.h"
+#include "RowSelection.h"
+
 namespace jux
 {
 class ListBox;
@@ -64,6 +67,42 @@ public:
                                    int height,
                                    bool rowIsSelected) = 0;
 
+    /** Override this to load row data asynchronously.
+
+        Return false if the data needed to paint or refresh a row isn't available yet. The
+        list then paints the row with paintRowPlaceholder() and doesn't call
+        refreshComponentForRow() for it. Start loading the data (e.g. on a juce::ThreadPool)
+        and call ListBox::rowsBecameReady() once it's there.
+
+        This is called while painting, so it must return quickly. Note that the rowNumber
+        may be greater than the number of rows in your list.
+
+        By default this returns true for every row.
+    */
+    virtual bool isRowReady (int rowNumber);
+
+    /** This draws a row whose data isn't ready yet.
+
+        The default implementation draws a faint bar. It should be cheap.
+        @see isRowReady
+    */
+    virtual void paintRowPlaceholder (int rowNumber,
+                                      juce::Graphics& g,
+                                      int width,
+                                      int height,
+                                      bool rowIsSelected);
+
+    /** Override this when using ListBox::setRowImageCacheSize().
+
+        Return a number that changes whenever what paintListBoxItem() draws for this
+        row changes, e.g. a revision counter for the row's data. A cached image of the
+        row is only re-used while this stays the same.
+
+        By default this returns 0, in which case cached rows are only thrown away by
+        ListBox::updateContent() and the other row change notifications.
+    */
+    virtual juce::int64 getRowContentVersion (int rowNumber);
+
     /** This is used to create or update a custom component to go in a row of the list.
 
         Any row may contain a custom component, or can just be drawn with the paintListBoxItem() method
@@ -93,10 +132,57 @@ public:
     */
     virtual juce::Component* refreshComponentForRow (int rowNumber, bool isRowSelected, juce::Component* existingComponentToUpdate);
 
+    /** Override this if different rows use different kinds of custom components.
+
+        The list keeps the custom components of rows that scroll out of view in a pool,
+        grouped by this id, and only ever passes a component to refreshComponentForRow()
+        as existingComponentToUpdate if it was created for a row with the same id. This
+        means you can cast it straight back to your own class, rather than deleting and
+        re-creating components whenever different kinds of rows scroll past each other.
+
+        By default every row has the id 0.
+    */
+    virtual int getRowTypeId (int rowNumber);
+
     /** This allows to have customized height for a row if needed.
     */
     virtual int getRowHeight (int rowNumber) const;
 
+    /** Override this to let the list measure rows lazily.
+
+        If this returns a positive value, ListBox::updateContent() won't call getRowHeight()
+        for every row. Each row starts with this estimated height instead, and getRowHeight()
+        is only called once the row comes near the visible area. The list keeps the row at
+        the top of the view in place while estimates get corrected.
+
+        By default this returns -1, which means all rows are measured up-front.
+    */
+    virtual int getEstimatedRowHeight() const;
+
+    /** Override this to provide the heights of a block of rows in one go.
+
+        When the list needs the heights of many rows (e.g. in ListBox::updateContent()) it
+        asks for them in blocks. If your heights are already stored in an array, you can
+        copy them straight into the destination instead of answering getRowHeight() for
+        each row.
+
+        @param rows      the rows to fill in, which are always within getNumRows()
+        @param heights   where to write rows.getLength() heights. Heights that aren't
+                         positive are replaced with the list's default row height.
+        @returns         true if the heights were written, or false to make the list
+                         fall back to calling getRowHeight() for each row (the default)
+    */
+    virtual bool getRowHeights (juce::Range<int> rows, int* heights) const;
+
+    /** Override this to return true if all rows have the same height.
+
+        ListBox::updateContent() then only calls getRowHeight() for the first row, rather
+        than for every row, and the list keeps that height once instead of once per row.
+
+        By default this returns false.
+    */
+    virtual bool hasUniformRowHeights() const;
+
     /** This can be overridden to return a name for the specified row.
 
         By default this will just return a string containing the row number.
@@ -121,6 +207,36 @@ public:
     */
     virtual void backgroundClicked (const juce::MouseEvent&);
 
+    /** Override this to handle the mouse inside a row yourself, e.g. for controls that
+        paintListBoxItem() draws.
+
+        The event's position is relative to the top-left of the row, which is width by
+        height pixels. Return true to take the mouse: the list then doesn't select or
+        drag the row, passes the rest of the gesture to rowMouseDrag() and rowMouseUp(),
+        and repaints the row after each of these calls.
+
+        By default this returns false.
+        @see CellListBoxModel
+    */
+    virtual bool rowMouseDown (int row, int width, int height, const juce::MouseEvent& e);
+
+    /** Called when the mouse is dragged after rowMouseDown() took it.
+        @see rowMouseDown
+    */
+    virtual void rowMouseDrag (int row, int width, int height, const juce::MouseEvent& e);
+
+    /** Called when the mouse is released after rowMouseDown() took it.
+        @see rowMouseDown
+    */
+    virtual void rowMouseUp (int row, int width, int height, const juce::MouseEvent& e);
+
+    /** Override this to handle keys for the last row selected, before the list uses them.
+
+        Return true if the key was used, and the list repaints the row. By default this
+        returns false.
+    */
+    virtual bool rowKeyPressed (int row, const juce::KeyPress& key);
+
     /** Override this to be informed when rows are selected or deselected.
 
         This will be called whenever a row is selected or deselected. If a range of
@@ -131,6 +247,45 @@ public:
     */
     virtual void selectedRowsChanged (int lastRowSelected);
 
+    /** Override this to find out exactly which rows a selection change affected.
+
+        This is called just before selectedRowsChanged(), with the rows that became
+        selected and the rows that stopped being selected. A row only appears in one
+        of them, and only if its state really changed, so a model can keep its own
+        per-row state in sync without comparing whole selections.
+
+        Changes that come from ListBox::rowsInserted(), rowsRemoved() or rowsMoved()
+        aren't reported here, as it's the rows themselves that moved.
+
+        @see ListBox::getSelection
+    */
+    virtual void selectedRowRangesChanged (const RowSelection& rowsSelected,
+                                           const RowSelection& rowsDeselected);
+
+    /** Override this to give rows an identity that survives re-sorting and filtering.
+
+        Return a key that stays with the item shown in the row, e.g. a database id.
+        The ListBox then remembers the keys of the selected rows, the last row selected
+        and the top visible row. After ListBox::updateContent() it finds these items
+        again with getRowForKey(), so the selection and the scroll position stay on them
+        wherever they've moved to. Items that aren't there any more are deselected.
+
+        This costs a call per row whose selection changes, one per display frame in which
+        another row has scrolled to the top, and a getRowForKey() per selected row when the
+        content is updated. The default returns no key, and the
+        selection is kept by row number.
+
+        @see getRowForKey
+    */
+    virtual std::optional<juce::int64> getRowKey (int rowNumber);
+
+    /** Must return the row showing the item with this key, or -1 if there isn't one.
+
+        Only used when getRowKey() returns keys. It's called once per selected row after
+        each ListBox::updateContent(), so it should be quick, e.g. a hash map lookup.
+    */
+    virtual int getRowForKey (juce::int64 key);
+
     /** Override this to be informed when the delete key is pressed.
 
         If no rows are selected when they press the key, this won't be called.
@@ -158,6 +313,39 @@ public:
     */
     virtual void listWasScrolled();
 
+    /** Called when the mouse moves onto a different row, if the list tracks hovering.
+
+        The rows that the mouse left and entered have already been repainted, so
+        paintListBoxItem() can draw a highlight by checking ListBox::getHoveredRow().
+
+        @param newHoveredRow    the row under the mouse, or -1 if it isn't over a row
+        @see ListBox::setHoverTrackingEnabled
+    */
+    virtual void hoveredRowChanged (int newHoveredRow);
+
+    /** Override this to prepare rows before they reach the screen.
+
+        While the list scrolls, this is called with the rows that are about to come into
+        view next (roughly a page past the rows that already have components, in the
+        direction of scrolling). It's a good place to start loading thumbnails or fetching
+        data, so that refreshComponentForRow() and paintListBoxItem() find it ready.
+
+        It is only called again when that range of rows changes.
+
+        @see ListBox::setOverscan
+    */
+    virtual void prefetchRows (juce::Range<int> rowsAboutToBeShown);
+
+    /** Called once per display frame while the list is on screen, before it repaints.
+
+        Models that get their data from other threads can use this to hand it over to
+        the list, e.g. by calling ListBox::rowsInserted(), so that all the changes made
+        since the previous frame cause a single relayout.
+
+        @see SnapshotListBoxModel
+    */
+    virtual void listBoxFrameUpdate (ListBox& listBox);
+
     /** To allow rows from your list to be dragged-and-dropped, implement this method.
 
         If this returns a non-null variant then when the user drags a row, the listbox will
@@ -256,6 +444,83 @@ public:
     */
     void updateContent();
 
+    /** Tells the list that rows have been inserted into the model.
+
+        This is a cheaper alternative to updateContent() when you know what changed:
+        only the new rows' heights are queried, the selection is shifted so that it
+        stays on the same items, and only the visible rows from startRow onwards
+        are refreshed.
+
+        Call this after the model has changed. This must only be called from the
+        main message thread.
+
+        @see rowsRemoved, rowsMoved, rowsChanged, updateContent
+    */
+    void rowsInserted (int startRow, int numRows);
+
+    /** Tells the list that rows have been removed from the model.
+
+        Any removed rows are deselected and the rest of the selection is shifted
+        to stay on the same items. If the selection changes, the model is notified.
+
+        @see rowsInserted, rowsMoved, rowsChanged, updateContent
+    */
+    void rowsRemoved (int startRow, int numRows);
+
+    /** Tells the list that a block of rows was moved inside the model.
+
+        @param startRow      the index the first moved row had before the move
+        @param numRows       the number of rows that were moved
+        @param newStartRow   the index the first moved row has after the move
+
+        @see rowsInserted, rowsRemoved, rowsChanged, updateContent
+    */
+    void rowsMoved (int startRow, int numRows, int newStartRow);
+
+    /** Tells the list that the content of some rows changed, without rows being
+        added or removed.
+
+        The heights of these rows are queried again, and those that are on-screen
+        are refreshed.
+
+        @see rowsInserted, rowsRemoved, rowsMoved, updateContent
+    */
+    void rowsChanged (juce::Range<int> rows);
+
+    /** Tells the list that the data of some rows finished loading.
+
+        Use this with ListBoxModel::isRowReady(). It can be called from any thread that
+        isn't a realtime one, e.g. from the job that loaded the data. The rows are added to
+        a juce::SparseSet behind a spin lock, which may allocate. They're collected and the
+        ones that are on-screen get refreshed and repainted together on the next display frame.
+    */
+    void rowsBecameReady (const juce::SparseSet<int>& rows);
+
+    /** Makes the list update its content on the next display frame.
+
+        Unlike updateContent(), this can be called often and from any thread that isn't
+        a realtime one: all the calls made before a frame result in a single updateContent().
+        It takes a spin lock that the message thread also takes, so don't call it from an
+        audio callback.
+
+        @see rowsChangedAsync
+    */
+    void updateContentAsync();
+
+    /** Tells the list that the content of some rows changed, and lets it catch up on
+        the next display frame.
+
+        This can be called from any thread that isn't a realtime one. The ranges are
+        added to a juce::SparseSet behind a spin lock, which may allocate. The ranges
+        passed in before a frame are merged, and the list then queries their heights
+        again and refreshes the ones that are on-screen with a single relayout. If the number of rows has changed
+        by then, or updateContentAsync() was called too, the list updates all of its
+        content instead.
+
+        @see rowsChanged, updateContentAsync
+    */
+    void rowsChangedAsync (juce::Range<int> rows);
+
     //==============================================================================
     /** Turns on multiple-selection of rows.
 
@@ -294,6 +559,25 @@ public:
     */
     void setMouseMoveSelectsRows (bool shouldSelect);
 
+    /** Makes the list keep track of the row that the mouse is over.
+
+        Unlike setMouseMoveSelectsRows(), this doesn't touch the selection. When the mouse
+        moves onto another row, only the old and new rows are repainted and
+        ListBoxModel::hoveredRowChanged() is called.
+
+        Whether a row is hovered is part of the images kept by setRowImageCacheSize(), so a
+        paintListBoxItem() that draws a hover highlight still works with the cache on.
+
+        @see getHoveredRow
+    */
+    void setHoverTrackingEnabled (bool shouldTrack);
+
+    /** Returns the row that the mouse is over, or -1 if there isn't one or the list
+        isn't tracking hovering.
+        @see setHoverTrackingEnabled
+    */
+    int getHoveredRow() const noexcept                      { return hoveredRow; }
+
     //==============================================================================
     /** Selects a row.
 
@@ -344,10 +628,25 @@ public:
     void flipRowSelection (int rowNumber);
 
     /** Returns a sparse set indicating the rows that are currently selected.
-        @see setSelectedRows
+
+        The set is built from getSelection() the first time it's asked for after the
+        selection changed, and kept until the selection changes again, so asking for it
+        repeatedly only costs a copy of its ranges. Prefer getSelection() for selections
+        made of many separate ranges.
+
+        @see setSelectedRows, getSelection
     */
     juce::SparseSet<int> getSelectedRows() const;
 
+    /** Returns the rows that are currently selected, without copying them.
+
+        Unlike getSelectedRows(), lookups in this are O(log R) however fragmented the
+        selection is. It changes along with the selection.
+
+        @see ListBoxModel::selectedRowRangesChanged
+    */
+    const RowSelection& getSelection() const noexcept { return selected; }
+
     /** Sets the rows that should be selected, based on an explicit set of ranges.
 
         If sendNotificationEventToModel is true, the ListBoxModel::selectedRowsChanged()
@@ -388,6 +687,34 @@ public:
     */
     int getLastRowSelected() const;
 
+    /** Starts a batch of selection changes.
+
+        Until the matching endSelectionChange(), selecting and deselecting rows only
+        changes the selection itself. The rows are refreshed, the list is scrolled to
+        the last row selected and the model and accessibility clients are notified once,
+        when the outermost batch ends. ListBoxModel::selectedRowRangesChanged() then gets
+        the net change of the whole batch.
+
+        Calls can be nested, and must be balanced. ScopedSelectionChange does it for you.
+    */
+    void beginSelectionChange();
+
+    /** Ends a batch of selection changes started with beginSelectionChange(). */
+    void endSelectionChange();
+
+    /** Calls beginSelectionChange() when created and endSelectionChange() when destroyed. */
+    class ScopedSelectionChange
+    {
+    public:
+        explicit ScopedSelectionChange (ListBox& lb) : listBox (lb) { listBox.beginSelectionChange(); }
+        ~ScopedSelectionChange() { listBox.endSelectionChange(); }
+
+    private:
+        ListBox& listBox;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedSelectionChange)
+    };
+
     /** Multiply-selects rows based on the modifier keys.
 
         If no modifier keys are down, this will select the given row and
@@ -462,7 +789,8 @@ public:
         the listbox.
 
         This may be off-screen, and the range of the row number that is passed-in is
-        not checked to see if it's a valid row.
+        not checked to see if it's a valid row. Positions far away from the view are
+        clamped, as a very long list can be taller than an int can hold.
     */
     juce::Rectangle<int> getRowPosition (int rowNumber,
                                          bool relativeToComponentTopLeft) const noexcept;
@@ -501,7 +829,15 @@ public:
     int getDefaultRowHeight() const noexcept;
 
     /** Returns the height of a row in the list.
-        @see setRowHeight
+
+        This is the height that was queried from the model on the last call to
+        updateContent(). Rows beyond the end of the list use the default height.
+
+        If the model provides an estimated row height, rows that haven't been near
+        the visible area yet return the estimate.
+        @see ListBoxModel::getEstimatedRowHeight
+
+        @see setDefaultRowHeight
     */
     int getRowHeight (int rowNumber) const noexcept;
 
@@ -512,6 +848,98 @@ public:
     */
     int getNumRowsOnScreen() const noexcept;
 
+    /** Makes the list keep rendered images of its rows.
+
+        Rows are cached per row number, selection state, hover state, size, display scale
+        and ListBoxModel::getRowContentVersion(). A row only goes through paintListBoxItem()
+        again when one of these changes, or when it was dropped from the cache to keep
+        it under maxBytes. This helps when painting a row is expensive and rows often get
+        repainted without changing, e.g. when scrolling.
+
+        Custom row components are not part of the cached images.
+
+        Pass 0 to turn the cache off, which is the default.
+    */
+    void setRowImageCacheSize (size_t maxBytes);
+
+    /** Returns the size set with setRowImageCacheSize(). */
+    size_t getRowImageCacheSize() const noexcept;
+
+    /** Makes the list paint its rows into fixed-height image tiles and reuse them.
+
+        While scrolling, tiles that are still on screen are just drawn again and only the
+        newly exposed ones go through paintListBoxItem(). Tiles a little beyond the visible
+        area are kept so that scrolling back and forth stays cheap.
+
+        Tiles are re-rendered when the layout, the selection or the
+        ListBoxModel::getRowContentVersion() of their rows changes, and after updateContent(),
+        rowsChanged(), rowsBecameReady(), repaintRow() or markRowDirty(). A plain repaint()
+        only refreshes them if the content version changed, so otherwise use repaintRow() or
+        markRowDirty() when a row's appearance changes.
+
+        Custom row components are painted on top of the tiles as usual.
+
+        The default is false.
+    */
+    void setScrollCacheEnabled (bool shouldBeEnabled);
+
+    /** Returns true if the scroll cache is enabled.
+        @see setScrollCacheEnabled
+    */
+    bool isScrollCacheEnabled() const noexcept { return scrollCacheEnabled; }
+
+    /** Makes the list paint its rows without a component for each of them.
+
+        The viewport's content component then paints all the visible rows in one pass
+        with paintListBoxItem(), and finds the row under the mouse from the row heights
+        for clicks, drags, tooltips and mouse cursors. This saves the cost of a component
+        per row in lists that show many rows and only paint them.
+
+        refreshComponentForRow() isn't called, so custom row components aren't shown.
+        Row components are still created while an accessibility client (e.g. a screen
+        reader) is active, but they don't paint or handle the mouse.
+
+        The default is false.
+    */
+    void setDirectPaintEnabled (bool shouldPaintDirectly);
+
+    /** Returns true if direct painting is enabled.
+        @see setDirectPaintEnabled
+    */
+    bool isDirectPaintEnabled() const noexcept { return directPaintEnabled; }
+
+    /** Sets how many pixels beyond the visible area should have row components ready.
+
+        Creating and refreshing rows in the same frame they become visible can cause
+        hitches when scrolling fast. With an overscan, rows are prepared while they're
+        still off-screen. Most of the overscan is put ahead of the scrolling direction.
+
+        The default is 0.
+        @see getOverscan, ListBoxModel::prefetchRows
+    */
+    void setOverscan (int numPixels);
+
+    /** Returns the overscan set with setOverscan(). */
+    int getOverscan() const noexcept;
+
+    /** Makes the list behave like a log that grows at the end.
+
+        While the view is scrolled to the bottom, rows added with rowsInserted() at the
+        end keep it there. Once the user scrolls away, the view stays on the same rows
+        instead, also when the oldest rows are dropped with rowsRemoved (0, n).
+
+        Appending rows and removing them from the start are O(1) amortised per row, so
+        use those rather than updateContent() to keep a long log cheap.
+
+        By default this is disabled. Enabling it scrolls to the bottom.
+    */
+    void setTailFollowEnabled (bool shouldFollowTail);
+
+    /** Returns true if tail-follow is enabled.
+        @see setTailFollowEnabled
+    */
+    bool isTailFollowEnabled() const noexcept { return tailFollowEnabled; }
+
     //==============================================================================
     /** A set of colour IDs to use to change the colour of various aspects of the label.
 
@@ -575,10 +1003,41 @@ public:
     /** Repaints one of the rows.
 
         This does not invoke updateContent(), it just invokes a straightforward repaint
-        for the area covered by this row.
+        for the area covered by this row. Any image of the row kept by
+        setRowImageCacheSize() is thrown away, so the row goes through paintListBoxItem()
+        again.
     */
     void repaintRow (int rowNumber) noexcept;
 
+    /** Marks a row whose appearance has changed, so that it's repainted on the next display frame.
+
+        Unlike repaintRow(), this can be called often and from any thread that isn't a
+        realtime one. The rows marked before a frame are repainted together, with one area
+        for each run of adjacent rows, and rows that aren't on-screen are skipped. It doesn't
+        query the row's height or refresh its custom component, see rowsChangedAsync() for that.
+
+        The marked rows are added to a juce::SparseSet behind a spin lock, which may
+        allocate and makes the message thread wait while another thread is adding to it.
+        Don't call this from an audio callback; queue the changes with something like
+        RealtimeListBoxModel instead.
+
+        @see setMinimumRowRepaintInterval
+    */
+    void markRowDirty (int rowNumber);
+
+    /** Limits how often markRowDirty() repaints the same row.
+
+        A row that was repainted less than this many milliseconds ago stays marked until
+        the interval has passed, so rows whose values change very quickly can't keep the
+        message thread busy.
+
+        The default is 0, which repaints marked rows on every frame.
+    */
+    void setMinimumRowRepaintInterval (int milliseconds);
+
+    /** Returns the value set by setMinimumRowRepaintInterval(). */
+    int getMinimumRowRepaintInterval() const noexcept;
+
     /** This fairly obscure method creates an image that shows the row components specified
         in rows (for example, these could be the currently selected row components).
 
@@ -597,6 +1056,11 @@ public:
 
         You may need to use this to change parameters such as whether scrollbars
         are shown, etc.
+
+        Lists taller than 2^24 pixels are scrolled through a window of that height that
+        moves along with the view, and show their own vertical scrollbar in place of the
+        viewport's. In those, the viewport's view position is relative to the window, so
+        use setVerticalPosition() or scrollToEnsureRowIsOnscreen() to scroll instead.
     */
     juce::Viewport* getViewport() const noexcept;
 
@@ -628,18 +1092,63 @@ private:
     //==============================================================================
     class ListViewport;
     class RowComponent;
+    class RowImageCache;
+    class HoverTracker;
     friend class ListViewport;
     friend class TableListBox;
     ListBoxModel* model = nullptr;
     std::unique_ptr<ListViewport> viewport;
     std::unique_ptr<Component> headerComponent;
     std::unique_ptr<MouseListener> mouseMoveSelector;
-    juce::SparseSet<int> selected;
+    std::unique_ptr<HoverTracker> hoverTracker;
+    std::unique_ptr<RowImageCache> rowImageCache;
+    RowSelection selected, pendingRowsSelected, pendingRowsDeselected;
+    mutable juce::SparseSet<int> selectedRowSet;
+    mutable juce::uint32 selectedRowSetRevision = 0;
+
+    std::unordered_set<juce::int64> selectedKeys;
+    std::optional<juce::int64> lastSelectedKey, topRowKey;
+    int topRow = -1, topRowOffset = 0, topRowKeyRow = -1, topRowKeyOffset = 0;
+    bool isRemappingSelection = false;
+
+    struct DeferredScroll
+    {
+        int row;
+        bool isMouseClick;
+    };
+
+    int selectionChangeDepth = 0, lastRowSelectedBeforeChange = -1;
+    std::optional<DeferredScroll> deferredScroll;
+    bool selectionNeedsContentUpdate = false, hasDeferredSelectionMessage = false, deferredMessageNotifiesModel = false;
     int totalItems = 0, rowHeight = 22, minimumRowWidth = 0;
-    int outlineThickness = 0;
-    std::vector<int> itemHeightSum {};
-    int lastRowSelected = -1;
+    int outlineThickness = 0, overscanPixels = 0;
+    RowHeightIndex rowHeights;
+    RowSelection measuredRows;
+    int estimatedRowHeight = -1;
+    int lastRowSelected = -1, hoveredRow = -1;
     bool multipleSelection = false, alwaysFlipSelection = false, hasDoneInitialUpdate = false, selectOnMouseDown = true;
+    bool scrollCacheEnabled = false, tailFollowEnabled = false, directPaintEnabled = false;
+
+    struct TailFollowAnchor
+    {
+        bool wasAtBottom;
+        int row;
+        juce::int64 offset;
+    };
+
+    std::unique_ptr<juce::VBlankAttachment> vBlankAttachment;
+    juce::SpinLock pendingReadyRowsLock;
+    juce::SparseSet<int> pendingReadyRows;
+    std::atomic<bool> hasPendingReadyRows { false };
+    juce::SpinLock pendingChangesLock;
+    juce::SparseSet<int> pendingChangedRows;
+    bool needsAsyncContentUpdate = false;
+    std::atomic<bool> hasPendingChanges { false };
+    juce::SpinLock dirtyRowsLock;
+    juce::SparseSet<int> dirtyRows;
+    std::atomic<bool> hasDirtyRows { false };
+    int minimumRowRepaintInterval = 0;
+    std::unordered_map<int, double> lastRowRepaintTimes;
 
 #if ! JUCE_DISABLE_ASSERTIONS
     std::weak_ptr<ListBoxModel::Empty> weakModelPtr;
@@ -651,6 +1160,29 @@ private:
     bool hasAccessibleHeaderComponent() const;
 
     void selectRowInternal (int rowNumber, bool dontScrollToShowThisRow, bool deselectOthersFirst, bool isMouseClick);
+    void addToSelection (juce::Range<int> rows);
+    void removeFromSelection (juce::Range<int> rows);
+    void replaceSelection (const RowSelection& newSelection);
+    void recordSelectionChange (const RowSelection& rowsSelected, const RowSelection& rowsDeselected);
+    void sendSelectionChangeMessage (juce::NotificationType notification = juce::sendNotification);
+    void updateContentsForSelection();
+    bool remapSelectionToKeys();
+    void trackSelectedKeys (const RowSelection& rowsSelected, const RowSelection& rowsDeselected);
+    void rememberTopRow (int row, int offset) noexcept  { topRow = row; topRowOffset = offset; }
+    void updateTopRowKey();
+    void setHoveredRow (int row);
+    void updateHoveredRow();
+    void refreshAfterRowsChanged (juce::Range<int> rowsToRefresh, bool selectionChanged);
+    std::optional<TailFollowAnchor> getTailFollowAnchor() const;
+    void restoreTailFollowAnchor (const TailFollowAnchor& anchor);
+    void applyPendingChanges();
+    void repaintDirtyRows();
+    void handleFrameUpdate();
+    void fillRowHeights (juce::Range<int> rows, int* dest) const;
+    bool isEstimatingRowHeights() const noexcept { return estimatedRowHeight > 0; }
+    bool measureRows (juce::Range<int> rows);
+    int getRowHeightFromModel (int rowNumber) const;
+    void updateRowHeightFromModel (int rowNumber);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ListBox)
 };
@@ -0,0 +1,343 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "ListBoxCells.h"
+
+namespace jux
+{
+juce::var ListBoxCell::mouseDown (juce::Rectangle<float>, juce::Point<float>, const juce::var&) { return {}; }
+juce::var ListBoxCell::mouseDrag (juce::Rectangle<float>, juce::Point<float>, const juce::var&) { return {}; }
+juce::var ListBoxCell::keyPressed (const juce::KeyPress&, const juce::var&) { return {}; }
+
+juce::Colour ListBoxCell::findListColour (const int colourId, const juce::Colour fallback) const
+{
+    return list != nullptr ? list->findColour (colourId) : fallback;
+}
+
+//==============================================================================
+LabelCell::LabelCell (juce::Font f, juce::Justification j)
+    : font (f), justification (j)
+{
+}
+
+void LabelCell::paint (juce::Graphics& g, juce::Rectangle<float> area, const juce::var& value, bool rowIsSelected)
+{
+    if (rowIsSelected)
+        g.setColour (selectedTextColour.value_or (findListColour (juce::TextEditor::highlightedTextColourId, juce::Colours::black)));
+    else
+        g.setColour (textColour.value_or (findListColour (ListBox::textColourId, juce::Colours::black)));
+
+    g.setFont (font);
+    g.drawText (value.toString(), area.reduced ((float) horizontalIndent, 0.0f), justification, true);
+}
+
+//==============================================================================
+void ToggleCell::paint (juce::Graphics& g, juce::Rectangle<float> area, const juce::var& value, bool)
+{
+    if (value.isVoid())
+        return;
+
+    const auto height = juce::jmin (20.0f, area.getHeight() - 8.0f);
+
+    if (height <= 0.0f)
+        return;
+
+    const auto b = area.withSizeKeepingCentre (juce::jmin (height * 1.8f, area.getWidth() - 8.0f), height);
+    const auto isOn = (bool) value;
+
+    g.setColour (isOn ? onBackgroundColour : offBackgroundColour);
+    g.fillRoundedRectangle (b, height * 0.5f);
+
+    auto circle = b.withWidth (height);
+
+    if (isOn)
+        circle.setX (b.getRight() - height);
+
+    g.setColour (switchColour);
+    g.fillEllipse (circle.reduced (2.0f));
+}
+
+juce::var ToggleCell::mouseDown (juce::Rectangle<float>, juce::Point<float>, const juce::var& value)
+{
+    return ! (bool) value;
+}
+
+juce::var ToggleCell::keyPressed (const juce::KeyPress& key, const juce::var& value)
+{
+    // return is left to the list, for ListBoxModel::returnKeyPressed()
+    if (key.isKeyCode (juce::KeyPress::spaceKey))
+        return ! (bool) value;
+
+    return {};
+}
+
+//==============================================================================
+ValueBarCell::ValueBarCell (juce::NormalisableRange<double> r, int decimalPlaces)
+    : range (r), numDecimalPlaces (decimalPlaces)
+{
+}
+
+void ValueBarCell::paint (juce::Graphics& g, juce::Rectangle<float> area, const juce::var& value, bool)
+{
+    if (value.isVoid())
+        return;
+
+    const auto bar = getBarArea (area);
+    const auto v = juce::jlimit (range.start, range.end, (double) value);
+
+    g.setColour (backgroundColour);
+    g.fillRect (bar);
+    g.setColour (barColour);
+    g.fillRect (bar.withWidth (bar.getWidth() * (float) range.convertTo0to1 (v)));
+
+    if (numDecimalPlaces >= 0)
+    {
+        g.setColour (textColour.value_or (findListColour (ListBox::textColourId, juce::Colours::black)));
+        g.setFont (juce::jmin (14.0f, bar.getHeight()));
+        g.drawText (juce::String (v, numDecimalPlaces), bar, juce::Justification::centred, false);
+    }
+}
+
+juce::var ValueBarCell::mouseDown (juce::Rectangle<float> area, juce::Point<float> position, const juce::var&)
+{
+    return getValueAt (area, position);
+}
+
+juce::var ValueBarCell::mouseDrag (juce::Rectangle<float> area, juce::Point<float> position, const juce::var&)
+{
+    return getValueAt (area, position);
+}
+
+juce::var ValueBarCell::keyPressed (const juce::KeyPress& key, const juce::var& value)
+{
+    const auto direction = key.isKeyCode (juce::KeyPress::rightKey) ? 1.0
+                         : key.isKeyCode (juce::KeyPress::leftKey) ? -1.0
+                         : 0.0;
+
+    if (direction == 0.0)
+        return {};
+
+    const auto step = juce::jmax (range.interval, (range.end - range.start) * keyStepProportion);
+    return range.snapToLegalValue ((double) value + direction * step);
+}
+
+juce::Rectangle<float> ValueBarCell::getBarArea (juce::Rectangle<float> area) const
+{
+    return area.reduced (4.0f);
+}
+
+juce::var ValueBarCell::getValueAt (juce::Rectangle<float> area, juce::Point<float> position) const
+{
+    const auto bar = getBarArea (area);
+
+    if (bar.getWidth() <= 0.0f)
+        return {};
+
+    const auto proportion = juce::jlimit (0.0f, 1.0f, (position.x - bar.getX()) / bar.getWidth());
+    return range.snapToLegalValue (range.convertFrom0to1 ((double) proportion));
+}
+
+//==============================================================================
+void MeterCell::paint (juce::Graphics& g, juce::Rectangle<float> area, const juce::var& value, bool)
+{
+    const auto bar = area.reduced (4.0f);
+    const auto level = juce::jlimit (0.0f, 1.0f, (float) value);
+
+    g.setColour (backgroundColour);
+    g.fillRect (bar);
+
+    const auto fillSection = [&] (float start, float end, juce::Colour colour)
+    {
+        end = juce::jmin (end, level);
+
+        if (end <= start)
+            return;
+
+        g.setColour (colour);
+        g.fillRect (bar.getX() + bar.getWidth() * start, bar.getY(), bar.getWidth() * (end - start), bar.getHeight());
+    };
+
+    fillSection (0.0f, warningLevel, normalColour);
+    fillSection (warningLevel, clipLevel, warningColour);
+    fillSection (clipLevel, 1.0f, clipColour);
+}
+
+//==============================================================================
+CellListBoxModel::CellListBoxModel (ListBox& listBoxToDrawFor)
+    : listBox (listBoxToDrawFor)
+{
+}
+
+void CellListBoxModel::addCell (std::unique_ptr<ListBoxCell> cell, const int width)
+{
+    jassert (cell != nullptr);
+    cell->list = &listBox;
+    cells.push_back ({ std::move (cell), juce::jmax (0, width) });
+    cellEdgesWidth = -1;
+}
+
+ListBoxCell* CellListBoxModel::getCell (const int cellIndex) const noexcept
+{
+    return juce::isPositiveAndBelow (cellIndex, getNumCells()) ? cells[(size_t) cellIndex].cell.get() : nullptr;
+}
+
+juce::Rectangle<float> CellListBoxModel::getCellArea (const int cellIndex, const int rowWidth, const int rowHeight) const
+{
+    if (! juce::isPositiveAndBelow (cellIndex, getNumCells()))
+        return {};
+
+    const auto& edges = getCellEdges (rowWidth);
+    const auto x = edges[(size_t) cellIndex];
+    return { x, 0.0f, edges[(size_t) cellIndex + 1] - x, (float) rowHeight };
+}
+
+const std::vector<float>& CellListBoxModel::getCellEdges (const int rowWidth) const
+{
+    // every row has the same width, so this is only worked out again when the list is resized
+    if (rowWidth == cellEdgesWidth)
+        return cellEdges;
+
+    auto fixedWidth = 0;
+    auto numSharingCells = 0;
+
+    for (auto& c : cells)
+    {
+        if (c.width > 0)
+            fixedWidth += c.width;
+        else
+            ++numSharingCells;
+    }
+
+    const auto sharedWidth = numSharingCells > 0 ? (float) juce::jmax (0, rowWidth - fixedWidth) / (float) numSharingCells : 0.0f;
+    auto x = 0.0f;
+
+    cellEdges.clear();
+    cellEdges.reserve (cells.size() + 1);
+
+    for (auto& c : cells)
+    {
+        cellEdges.push_back (x);
+        x += c.width > 0 ? (float) c.width : sharedWidth;
+    }
+
+    cellEdges.push_back (x);
+    cellEdgesWidth = rowWidth;
+    return cellEdges;
+}
+
+void CellListBoxModel::setCellValue (int, int, const juce::var&) {}
+
+void CellListBoxModel::paintRowBackground (int, juce::Graphics& g, int, int, bool rowIsSelected)
+{
+    if (rowIsSelected)
+        g.fillAll (listBox.findColour (juce::TextEditor::highlightColourId));
+}
+
+void CellListBoxModel::paintListBoxItem (int row, juce::Graphics& g, int width, int height, bool rowIsSelected)
+{
+    paintRowBackground (row, g, width, height, rowIsSelected);
+
+    if (! juce::isPositiveAndBelow (row, getNumRows()))
+        return;
+
+    for (auto i = 0; i < getNumCells(); ++i)
+    {
+        const auto area = getCellArea (i, width, height);
+
+        if (g.clipRegionIntersects (area.getSmallestIntegerContainer()))
+            cells[(size_t) i].cell->paint (g, area, getCellValue (row, i), rowIsSelected);
+    }
+}
+
+bool CellListBoxModel::rowMouseDown (int row, int width, int height, const juce::MouseEvent& e)
+{
+    const auto cellIndex = getCellAt (e.position.x, width);
+    auto* cell = getCell (cellIndex);
+
+    if (cell == nullptr || ! cell->isInteractive())
+        return false;
+
+    cellWithMouse = lastClickedCell = cellIndex;
+    applyNewValue (row, cellIndex, cell->mouseDown (getCellArea (cellIndex, width, height), e.position, getCellValue (row, cellIndex)));
+    return true;
+}
+
+void CellListBoxModel::rowMouseDrag (int row, int width, int height, const juce::MouseEvent& e)
+{
+    if (auto* cell = getCell (cellWithMouse))
+        applyNewValue (row, cellWithMouse, cell->mouseDrag (getCellArea (cellWithMouse, width, height), e.position, getCellValue (row, cellWithMouse)));
+}
+
+void CellListBoxModel::rowMouseUp (int, int, int, const juce::MouseEvent&)
+{
+    cellWithMouse = -1;
+}
+
+bool CellListBoxModel::rowKeyPressed (int row, const juce::KeyPress& key)
+{
+    const auto cellIndex = getKeyboardCell();
+
+    if (cellIndex < 0)
+        return false;
+
+    const auto newValue = cells[(size_t) cellIndex].cell->keyPressed (key, getCellValue (row, cellIndex));
+
+    if (newValue.isVoid())
+        return false;
+
+    applyNewValue (row, cellIndex, newValue);
+    return true;
+}
+
+int CellListBoxModel::getCellAt (const float x, const int rowWidth) const
+{
+    const auto& edges = getCellEdges (rowWidth);
+
+    if (x < edges.front() || x >= edges.back())
+        return -1;
+
+    // the last edge at or before x starts the cell; empty cells are skipped over
+    return (int) (std::upper_bound (edges.begin(), edges.end(), x) - edges.begin()) - 1;
+}
+
+int CellListBoxModel::getKeyboardCell() const
+{
+    if (auto* cell = getCell (lastClickedCell))
+        if (cell->isInteractive())
+            return lastClickedCell;
+
+    return -1;
+}
+
+void CellListBoxModel::applyNewValue (const int row, const int cellIndex, const juce::var& newValue)
+{
+    if (! newValue.isVoid())
+        setCellValue (row, cellIndex, newValue);
+}
+
+} // namespace jux
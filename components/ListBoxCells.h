@@ -0,0 +1,276 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ListBox.h"
+
+namespace jux
+{
+//==============================================================================
+/**
+    Draws one value inside a list row and optionally lets the user change it,
+    without being a Component.
+
+    A cell is shared by every row of its column: it gets the row's value each time
+    it paints or handles an event, so scrolling a list of cells only repaints it
+    rather than re-laying out components. Values that a cell can't use (e.g. a
+    void var for a row without one) should be drawn as empty.
+
+    @see CellListBoxModel
+*/
+class ListBoxCell
+{
+public:
+    virtual ~ListBoxCell() = default;
+
+    /** Draws the cell for a row. */
+    virtual void paint (juce::Graphics& g, juce::Rectangle<float> area, const juce::var& value, bool rowIsSelected) = 0;
+
+    /** Returns true if the cell handles the mouse and keys. Cells that don't let
+        the row be selected and dragged as usual.
+    */
+    virtual bool isInteractive() const { return false; }
+
+    /** Called when the mouse is pressed in the cell.
+        Returns the new value, or a void var to leave it unchanged.
+    */
+    virtual juce::var mouseDown (juce::Rectangle<float> area, juce::Point<float> position, const juce::var& value);
+
+    /** Called as the mouse is dragged after being pressed in the cell.
+        Returns the new value, or a void var to leave it unchanged.
+    */
+    virtual juce::var mouseDrag (juce::Rectangle<float> area, juce::Point<float> position, const juce::var& value);
+
+    /** Called when a key is pressed while the cell's row is the last one selected,
+        if this is the interactive cell that the user last clicked.
+        Returns the new value, or a void var if the key wasn't used.
+    */
+    virtual juce::var keyPressed (const juce::KeyPress& key, const juce::var& value);
+
+protected:
+    /** Returns a colour of the list that the cell is drawn in, or the fallback colour
+        if the cell hasn't been added to a CellListBoxModel.
+    */
+    juce::Colour findListColour (int colourId, juce::Colour fallback) const;
+
+private:
+    friend class CellListBoxModel;
+    const juce::Component* list = nullptr;
+};
+
+//==============================================================================
+/** A cell that shows some text. */
+class LabelCell : public ListBoxCell
+{
+public:
+    LabelCell (juce::Font font = juce::Font (15.0f),
+               juce::Justification justification = juce::Justification::centredLeft);
+
+    void paint (juce::Graphics&, juce::Rectangle<float>, const juce::var&, bool) override;
+
+    juce::Font font;
+    juce::Justification justification;
+
+    /** The text colours. When not set, the list's ListBox::textColourId colour is used,
+        and juce::TextEditor::highlightedTextColourId for selected rows.
+    */
+    std::optional<juce::Colour> textColour, selectedTextColour;
+    int horizontalIndent = 4;
+};
+
+//==============================================================================
+/** A switch for a bool value, which toggles when clicked or when space is pressed.
+    @see SwitchButton
+*/
+class ToggleCell : public ListBoxCell
+{
+public:
+    void paint (juce::Graphics&, juce::Rectangle<float>, const juce::var&, bool) override;
+
+    bool isInteractive() const override { return true; }
+    juce::var mouseDown (juce::Rectangle<float>, juce::Point<float>, const juce::var&) override;
+    juce::var keyPressed (const juce::KeyPress&, const juce::var&) override;
+
+    juce::Colour switchColour = juce::Colours::white;
+    juce::Colour onBackgroundColour = juce::Colours::limegreen, offBackgroundColour = juce::Colours::darkgrey;
+};
+
+//==============================================================================
+/** A horizontal bar showing a number in a range, which can be dragged or
+    changed with the left and right keys.
+*/
+class ValueBarCell : public ListBoxCell
+{
+public:
+    explicit ValueBarCell (juce::NormalisableRange<double> range = { 0.0, 1.0 }, int numDecimalPlaces = 2);
+
+    void paint (juce::Graphics&, juce::Rectangle<float>, const juce::var&, bool) override;
+
+    bool isInteractive() const override { return true; }
+    juce::var mouseDown (juce::Rectangle<float>, juce::Point<float>, const juce::var&) override;
+    juce::var mouseDrag (juce::Rectangle<float>, juce::Point<float>, const juce::var&) override;
+    juce::var keyPressed (const juce::KeyPress&, const juce::var&) override;
+
+    juce::NormalisableRange<double> range;
+
+    /** The number of decimal places of the text drawn on the bar, or -1 to draw no text. */
+    int numDecimalPlaces;
+
+    /** How much of the range the left and right keys move the value by. */
+    double keyStepProportion = 0.01;
+
+    juce::Colour barColour = juce::Colours::cornflowerblue, backgroundColour = juce::Colours::lightgrey;
+
+    /** The colour of the text, or the list's ListBox::textColourId colour when not set. */
+    std::optional<juce::Colour> textColour;
+
+private:
+    juce::Rectangle<float> getBarArea (juce::Rectangle<float> area) const;
+    juce::var getValueAt (juce::Rectangle<float> area, juce::Point<float> position) const;
+};
+
+//==============================================================================
+/** A horizontal level meter for a gain between 0 and 1, which turns from green to
+    yellow and red as it gets near the top.
+*/
+class MeterCell : public ListBoxCell
+{
+public:
+    void paint (juce::Graphics&, juce::Rectangle<float>, const juce::var&, bool) override;
+
+    /** The levels at which the meter turns yellow and red. */
+    float warningLevel = 0.7f, clipLevel = 0.95f;
+
+    juce::Colour backgroundColour = juce::Colours::black;
+    juce::Colour normalColour = juce::Colours::limegreen, warningColour = juce::Colours::yellow, clipColour = juce::Colours::red;
+};
+
+//==============================================================================
+/**
+    A ListBoxModel whose rows are split into columns of ListBoxCells.
+
+    The list paints the cells and hands the mouse and keys to them, so rows need no
+    components: the model only returns the value of each cell with getCellValue(),
+    and is told about the values the user changes through setCellValue().
+
+    Keys go to the interactive cell the user last clicked, in the last row selected.
+    Until the user clicks one, the list handles all keys itself.
+
+    Cells are drawn with paintListBoxItem(), so if you use ListBox::setRowImageCacheSize(),
+    getRowContentVersion() has to change along with the values.
+
+    @code
+    struct ChannelsModel : public jux::CellListBoxModel
+    {
+        explicit ChannelsModel (jux::ListBox& list) : CellListBoxModel (list)
+        {
+            addCell (std::make_unique<jux::LabelCell>(), 120);
+            addCell (std::make_unique<jux::ToggleCell>(), 50);
+            addCell (std::make_unique<jux::ValueBarCell>());
+            addCell (std::make_unique<jux::MeterCell>());
+        }
+
+        juce::var getCellValue (int row, int cell) override;
+        void setCellValue (int row, int cell, const juce::var& newValue) override;
+        int getNumRows() override;
+    };
+    @endcode
+
+    @see ListBoxCell, ListBoxModel::rowMouseDown
+*/
+class CellListBoxModel : public ListBoxModel
+{
+public:
+    //==============================================================================
+    /** Creates a model for a list, which it takes its colours from. */
+    explicit CellListBoxModel (ListBox& listBoxToDrawFor);
+
+    /** Adds a cell to the right of the existing ones.
+
+        @param cell    the cell, which the model takes ownership of
+        @param width   the cell's width in pixels, or 0 to share the width left over by
+                       the fixed-width cells equally with the other cells of width 0
+    */
+    void addCell (std::unique_ptr<ListBoxCell> cell, int width = 0);
+
+    /** Returns the number of cells in each row. */
+    int getNumCells() const noexcept { return (int) cells.size(); }
+
+    /** Returns one of the cells, or nullptr if the index is out of range. */
+    ListBoxCell* getCell (int cellIndex) const noexcept;
+
+    /** Returns the area that a cell takes up in a row of the given size. */
+    juce::Rectangle<float> getCellArea (int cellIndex, int rowWidth, int rowHeight) const;
+
+    //==============================================================================
+    /** Must return the value a cell shows for a row. */
+    virtual juce::var getCellValue (int row, int cellIndex) = 0;
+
+    /** Called when the user changes the value of a cell. The row is repainted afterwards. */
+    virtual void setCellValue (int row, int cellIndex, const juce::var& newValue);
+
+    /** Draws the row's background, underneath the cells. By default this fills selected
+        rows with the list's juce::TextEditor::highlightColourId colour.
+    */
+    virtual void paintRowBackground (int row, juce::Graphics& g, int width, int height, bool rowIsSelected);
+
+    //==============================================================================
+    /** @internal */
+    void paintListBoxItem (int, juce::Graphics&, int, int, bool) override;
+    /** @internal */
+    bool rowMouseDown (int, int, int, const juce::MouseEvent&) override;
+    /** @internal */
+    void rowMouseDrag (int, int, int, const juce::MouseEvent&) override;
+    /** @internal */
+    void rowMouseUp (int, int, int, const juce::MouseEvent&) override;
+    /** @internal */
+    bool rowKeyPressed (int, const juce::KeyPress&) override;
+
+private:
+    struct Column
+    {
+        std::unique_ptr<ListBoxCell> cell;
+        int width;
+    };
+
+    const std::vector<float>& getCellEdges (int rowWidth) const;
+    int getCellAt (float x, int rowWidth) const;
+    int getKeyboardCell() const;
+    void applyNewValue (int row, int cellIndex, const juce::var& newValue);
+
+    ListBox& listBox;
+    std::vector<Column> cells;
+
+    // the x position of each cell's left edge and of the last one's right edge, for cellEdgesWidth
+    mutable std::vector<float> cellEdges;
+    mutable int cellEdgesWidth = -1;
+    int cellWithMouse = -1, lastClickedCell = -1;
+};
+
+} // namespace jux
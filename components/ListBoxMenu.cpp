@@ -110,6 +110,11 @@ void ListBoxMenu::setBackButtonShowText (bool showText)
     resized();
 }
 
+void ListBoxMenu::setHoverHighlightEnabled (bool shouldHighlight)
+{
+    list.setHoverTrackingEnabled (shouldHighlight);
+}
+
 void ListBoxMenu::animateAndClose (const bool removeComponent)
 {
     if (getParentComponent())
@@ -144,58 +149,32 @@ juce::Component* ListBoxMenu::getCustomComponentIfValid (int rowNumber)
     return (*currentRoot->subMenu)[(size_t) rowNumber].customComponent.get();
 }
 
-Component* ListBoxMenu::refreshComponentForRow (int rowNumber, bool isRowSelected, Component* existingComponentToUpdate)
+int ListBoxMenu::getRowTypeId (int rowNumber)
 {
-    juce::Component* customComponent = getCustomComponentIfValid (rowNumber);
+    return getCustomComponentIfValid (rowNumber) != nullptr ? customComponentRowTypeId : menuRowTypeId;
+}
 
-    RowComponent* c = nullptr;
-    if (existingComponentToUpdate == nullptr)
+Component* ListBoxMenu::refreshComponentForRow (int rowNumber, bool isRowSelected, Component* existingComponentToUpdate)
+{
+    // the list only recycles components between rows with the same getRowTypeId()
+    if (auto* customComponent = getCustomComponentIfValid (rowNumber))
     {
-        if (customComponent)
-        {
+        if (existingComponentToUpdate == nullptr)
             return new CustomComponentWrapper (customComponent);
-        }
-        c = new RowComponent (*this);
-    }
-    else
-    {
-        if (customComponent)
-        {
-            auto customWrapper = dynamic_cast<CustomComponentWrapper*> (existingComponentToUpdate);
-            if (customWrapper != nullptr)
-            {
-                customWrapper->updateComponent (customComponent);
-                return customWrapper;
-            }
-            else
-            {
-                delete existingComponentToUpdate;
-                return new CustomComponentWrapper (customComponent);
-            }
-        }
-        else
-        {
-            c = dynamic_cast<RowComponent*> (existingComponentToUpdate);
-            if (c == nullptr)
-            {
-                delete existingComponentToUpdate;
-                c = new RowComponent (*this);
-            }
-        }
-    }
 
-    if (c != nullptr)
-    {
-        c->rowNumber = rowNumber;
-        c->isRowSelected = isRowSelected;
-        c->parent = this;
-        return c;
+        jassert (dynamic_cast<CustomComponentWrapper*> (existingComponentToUpdate) != nullptr);
+        auto* customWrapper = static_cast<CustomComponentWrapper*> (existingComponentToUpdate);
+        customWrapper->updateComponent (customComponent);
+        return customWrapper;
     }
 
-    if (existingComponentToUpdate != nullptr)
-        jassertfalse;
-
-    return existingComponentToUpdate;
+    jassert (existingComponentToUpdate == nullptr || dynamic_cast<RowComponent*> (existingComponentToUpdate) != nullptr);
+    auto* c = existingComponentToUpdate != nullptr ? static_cast<RowComponent*> (existingComponentToUpdate)
+                                                   : new RowComponent (*this);
+    c->rowNumber = rowNumber;
+    c->isRowSelected = isRowSelected;
+    c->parent = this;
+    return c;
 }
 
 void ListBoxMenu::invokeItemEventsIfNeeded (Item& item)
@@ -579,7 +558,7 @@ void ListBoxMenu::RowComponent::paint (juce::Graphics& g)
         if (item.isSectionHeader)
             getLookAndFeel().drawPopupMenuSectionHeader (g, getLocalBounds(), item.text);
         else
-            getLookAndFeel().drawPopupMenuItem (g, { 0, 0, getWidth(), getHeight() }, item.isSeparator, item.isEnabled, (isRowSelected || isDown || isSecondary) && item.isEnabled, item.isTicked, item.subMenu != nullptr, item.text, item.shortcutKeyDescription, item.image.get(), item.colour.isTransparent() ? nullptr : &item.colour);
+            getLookAndFeel().drawPopupMenuItem (g, { 0, 0, getWidth(), getHeight() }, item.isSeparator, item.isEnabled, (isRowSelected || isDown || isSecondary || parent->list.getHoveredRow() == rowNumber) && item.isEnabled, item.isTicked, item.subMenu != nullptr, item.text, item.shortcutKeyDescription, item.image.get(), item.colour.isTransparent() ? nullptr : &item.colour);
     }
 }
 
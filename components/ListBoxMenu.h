@@ -91,9 +91,16 @@ public:
     void setShouldCloseOnItemClick (bool shouldClose, std::function<void()> onMenuClosed = nullptr);
     void setBackButtonShowText (bool showText);
 
+    /** When set to true, the item under the mouse is highlighted like a selected one.
+        This is off by default, as it tracks every mouse move over the menu.
+        @see ListBox::setHoverTrackingEnabled
+    */
+    void setHoverHighlightEnabled (bool shouldHighlight);
+
     int getNumRows() override;
     void paintListBoxItem (int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
     Component* refreshComponentForRow (int rowNumber, bool isRowSelected, Component* existingComponentToUpdate) override;
+    int getRowTypeId (int rowNumber) override;
     void listBoxItemClicked (int row, const juce::MouseEvent&) override;
     void listBoxItemClicked (int row, bool isSecondaryClick);
     void deleteKeyPressed (int lastRowSelected) override;
@@ -115,6 +122,12 @@ private:
     friend class RowAccessibilityHandler;
     int lastSelectedRow { -1 };
 
+    enum RowTypeIds
+    {
+        menuRowTypeId = 0,
+        customComponentRowTypeId
+    };
+
     juce::Component* getCustomComponentIfValid (int rowNumber);
     juce::Value selectedId;
     void updateSelectedId (int newSelection);
@@ -206,6 +219,8 @@ private:
         void updateComponent (Component* componentToUpdate)
         {
             jassert (componentToUpdate != nullptr);
+            if (nonOwnedComponent != componentToUpdate)
+                removeChildComponent (nonOwnedComponent);
             nonOwnedComponent = componentToUpdate;
             addAndMakeVisible (nonOwnedComponent);
             resized();
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ListBox.h"
+
+namespace jux
+{
+//==============================================================================
+/**
+    A ListBoxModel that can be fed from a realtime thread, e.g. the audio callback.
+
+    push() copies a record into a preallocated single-producer/single-consumer queue,
+    without allocating or locking. Once per display frame the list drains the queue
+    and appends everything that arrived as one batch. The model keeps at most
+    maxRows records, dropping the oldest ones from the top of the list, so this works
+    well with ListBox::setTailFollowEnabled().
+
+    When the queue is full, push() drops the record and counts it, see getNumDropped().
+
+    Subclasses implement paintListBoxItem() using getRecord(). Only one thread may
+    push at a time, and the model should only be shown by one ListBox.
+
+    @see ListBoxModel::listBoxFrameUpdate
+*/
+template <typename Record>
+class RealtimeListBoxModel : public ListBoxModel
+{
+public:
+    static_assert (std::is_trivially_copyable<Record>::value, "Records are copied between threads, so must be trivially copyable");
+
+    //==============================================================================
+    /** Creates a model whose queue holds queueSize records between two frames, and
+        which keeps the last maxRows records.
+    */
+    RealtimeListBoxModel (int queueSize, int maxRows)
+        : fifo (queueSize + 1), queue ((size_t) queueSize + 1), rows ((size_t) juce::jmax (1, maxRows))
+    {
+        jassert (queueSize > 0 && maxRows > 0);
+    }
+
+    /** Adds a record to the queue. This is realtime-safe and can be called from any
+        one thread. Returns false if the queue was full and the record was dropped.
+    */
+    bool push (const Record& record) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+        {
+            numDropped.fetch_add (1, std::memory_order_relaxed);
+            return false;
+        }
+
+        queue[(size_t) (size1 > 0 ? start1 : start2)] = record;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    /** Returns the number of records that push() dropped because the queue was full. */
+    juce::uint32 getNumDropped() const noexcept { return numDropped.load (std::memory_order_relaxed); }
+
+    /** Returns one of the records shown by the list. Only call this on the message thread. */
+    const Record& getRecord (int row) const noexcept
+    {
+        jassert (juce::isPositiveAndBelow (row, numRows));
+        return rows[(size_t) ((firstRow + row) % (int) rows.size())];
+    }
+
+    //==============================================================================
+    int getNumRows() override { return numRows; }
+
+    /** Drains the queue into the list. */
+    void listBoxFrameUpdate (ListBox& listBox) override
+    {
+        const auto numReady = fifo.getNumReady();
+
+        if (numReady == 0)
+            return;
+
+        const auto capacity = (int) rows.size();
+        const auto numRowsBefore = numRows;
+        auto numEvicted = 0;
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (numReady, start1, size1, start2, size2);
+
+        // records that would be evicted again straight away aren't copied
+        for (auto i = juce::jmax (0, numReady - capacity); i < numReady; ++i)
+        {
+            const auto& record = queue[(size_t) (i < size1 ? start1 + i : start2 + i - size1)];
+
+            if (numRows == capacity)
+            {
+                rows[(size_t) firstRow] = record;
+                firstRow = (firstRow + 1) % capacity;
+                ++numEvicted;
+            }
+            else
+            {
+                rows[(size_t) ((firstRow + numRows) % capacity)] = record;
+                ++numRows;
+            }
+        }
+
+        fifo.finishedRead (size1 + size2);
+
+        // the list checks the row count after each change, so the rows appear in two steps
+        const auto numAppended = numRows - (numRowsBefore - numEvicted);
+        numRows = numRowsBefore - numEvicted;
+        listBox.rowsRemoved (0, numEvicted);
+
+        numRows += numAppended;
+        listBox.rowsInserted (numRows - numAppended, numAppended);
+    }
+
+private:
+    //==============================================================================
+    juce::AbstractFifo fifo;
+    std::vector<Record> queue;
+    std::atomic<juce::uint32> numDropped { 0 };
+
+    // a ring buffer of the rows shown, starting at firstRow
+    std::vector<Record> rows;
+    int firstRow = 0, numRows = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeListBoxModel)
+};
+
+} // namespace jux
@@ -0,0 +1,713 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "RowHeightIndex.h"
+
+namespace jux
+{
+static int lowestBit (int k) noexcept { return k & -k; }
+
+void RowHeightIndex::buildUniform (const int numRows, const int height)
+{
+    jassert (numRows >= 0 && height > 0);
+
+    clear();
+
+    if (numRows > 0)
+        runs.append (numRows, height);
+
+    totalHeight = runs.getTotalHeight();
+}
+
+void RowHeightIndex::clear()
+{
+    compressed = true;
+    firstRow = 0;
+    firstRowY = 0;
+    runs.clear();
+    heights.clear();
+    tree.clear();
+    highestStep = 0;
+    totalHeight = 0;
+    ++revision;
+}
+
+void RowHeightIndex::removeRows (const int startRow, const int numRows)
+{
+    jassert (startRow >= 0 && numRows >= 0 && startRow + numRows <= size());
+
+    if (startRow == 0)
+    {
+        removeFirstRows (numRows);
+        return;
+    }
+
+    compact();
+
+    if (compressed)
+    {
+        runs.removeRows (startRow, numRows);
+        runsChanged();
+        decompressIfTooManyRuns();
+        return;
+    }
+
+    const auto first = heights.begin() + startRow;
+    heights.erase (first, first + numRows);
+    rebuildTree();
+}
+
+void RowHeightIndex::removeFirstRows (const int numRows)
+{
+    jassert (juce::isPositiveAndNotGreaterThan (numRows, size()));
+
+    if (numRows <= 0)
+        return;
+
+    firstRow += numRows;
+    firstRowY = getStoredRowY (firstRow);
+    ++revision;
+
+    if (firstRow > getNumStoredRows() / 2)
+        compact();
+}
+
+void RowHeightIndex::moveRows (const int startRow, const int numRows, const int newStartRow)
+{
+    jassert (startRow >= 0 && numRows >= 0 && startRow + numRows <= size());
+    jassert (juce::isPositiveAndNotGreaterThan (newStartRow, size() - numRows));
+
+    if (newStartRow == startRow)
+        return;
+
+    compact();
+
+    if (compressed)
+    {
+        runs.moveRows (startRow, numRows, newStartRow);
+        runsChanged();
+        decompressIfTooManyRuns();
+        return;
+    }
+
+    const auto begin = heights.begin();
+
+    if (newStartRow < startRow)
+        std::rotate (begin + newStartRow, begin + startRow, begin + startRow + numRows);
+    else
+        std::rotate (begin + startRow, begin + startRow + numRows, begin + newStartRow + numRows);
+
+    rebuildTree();
+}
+
+int RowHeightIndex::getHeight (const int row) const noexcept
+{
+    jassert (juce::isPositiveAndBelow (row, size()));
+
+    if (compressed)
+        return runs.findRow (firstRow + row).height;
+
+    return heights[(size_t) (firstRow + row)];
+}
+
+void RowHeightIndex::setHeight (const int row, const int newHeight)
+{
+    jassert (juce::isPositiveAndBelow (row, size()));
+    jassert (newHeight > 0);
+
+    const auto storedRow = firstRow + row;
+
+    if (compressed)
+    {
+        if (runs.findRow (storedRow).height == newHeight)
+            return;
+
+        runs.setHeight (storedRow, newHeight);
+        runsChanged();
+        decompressIfTooManyRuns();
+        return;
+    }
+
+    const auto delta = newHeight - heights[(size_t) storedRow];
+
+    if (delta == 0)
+        return;
+
+    heights[(size_t) storedRow] = newHeight;
+    totalHeight += delta;
+    ++revision;
+
+    for (auto k = storedRow + 1; k <= getNumStoredRows(); k += lowestBit (k))
+        tree[(size_t) k] += delta;
+}
+
+juce::int64 RowHeightIndex::getRowY (const int row) const noexcept
+{
+    jassert (juce::isPositiveAndNotGreaterThan (row, size()));
+    return getStoredRowY (firstRow + row) - firstRowY;
+}
+
+int RowHeightIndex::getRowContaining (const juce::int64 y) const noexcept
+{
+    if (y < 0)
+        return -1;
+
+    return getStoredRowContaining (firstRowY + y) - firstRow;
+}
+
+//==============================================================================
+void RowHeightIndex::replaceNonPositive (int* dest, const int num, const int replacement) noexcept
+{
+    // branch-free so that the compiler can vectorise it
+    for (auto i = 0; i < num; ++i)
+        dest[i] = dest[i] > 0 ? dest[i] : replacement;
+}
+
+bool RowHeightIndex::shouldCompress (const size_t numRuns, const int numRows) noexcept
+{
+    return numRuns <= 1 || (numRuns <= (size_t) maxRuns && numRuns * 4 <= (size_t) numRows);
+}
+
+juce::int64 RowHeightIndex::getStoredRowY (const int storedRow) const noexcept
+{
+    if (compressed)
+    {
+        if (storedRow >= runs.getNumRows())
+            return totalHeight;
+
+        const auto run = runs.findRow (storedRow);
+        return run.y + (juce::int64) (storedRow - run.firstRow) * run.height;
+    }
+
+    juce::int64 y = 0;
+
+    for (auto k = storedRow; k > 0; k -= lowestBit (k))
+        y += tree[(size_t) k];
+
+    return y;
+}
+
+int RowHeightIndex::getStoredRowContaining (const juce::int64 storedY) const noexcept
+{
+    if (compressed)
+    {
+        if (storedY >= totalHeight)
+            return runs.getNumRows();
+
+        const auto run = runs.findY (storedY);
+        return run.firstRow + (int) ((storedY - run.y) / run.height);
+    }
+
+    // binary lifting: find the number of rows whose bottom is at or above y
+    const auto numStoredRows = getNumStoredRows();
+    auto row = 0;
+    auto remaining = storedY;
+
+    for (auto step = highestStep; step > 0; step >>= 1)
+    {
+        const auto next = row + step;
+
+        if (next <= numStoredRows && tree[(size_t) next] <= remaining)
+        {
+            row = next;
+            remaining -= tree[(size_t) next];
+        }
+    }
+
+    return row;
+}
+
+/*  Adds heights after the stored rows. The runs are kept up to date, but a tree has
+    to be updated afterwards with finishBuilding() or finishAppending().
+*/
+void RowHeightIndex::appendHeights (const int* src, const int num, const int expectedNumStoredRows)
+{
+    if (! compressed)
+    {
+        heights.insert (heights.end(), src, src + num);
+        return;
+    }
+
+    for (auto i = 0; i < num;)
+    {
+        const auto height = src[i];
+        auto end = i + 1;
+
+        while (end < num && src[end] == height)
+            ++end;
+
+        runs.append (end - i, height);
+        i = end;
+    }
+
+    totalHeight = runs.getTotalHeight();
+
+    if (! shouldCompress ((size_t) runs.getNumRuns(), expectedNumStoredRows))
+    {
+        heights.reserve ((size_t) expectedNumStoredRows);
+        decompress();
+    }
+}
+
+void RowHeightIndex::finishBuilding()
+{
+    if (compressed)
+        ++revision;
+    else
+        rebuildTree();
+}
+
+void RowHeightIndex::finishAppending (const bool wasCompressed, const int numStoredRowsBefore)
+{
+    if (compressed)
+        ++revision;
+    else if (wasCompressed)
+        rebuildTree();
+    else
+        extendTree (numStoredRowsBefore);
+}
+
+void RowHeightIndex::insert (const int startRow, const RowHeightIndex& newRows)
+{
+    if (newRows.size() == 0)
+        return;
+
+    compact();
+
+    if (compressed && newRows.compressed)
+    {
+        runs.insertRows (startRow, newRows.runs);
+        runsChanged();
+        decompressIfTooManyRuns();
+        return;
+    }
+
+    if (compressed)
+        decompress();
+
+    const auto first = heights.insert (heights.begin() + startRow, (size_t) newRows.size(), 0);
+    newRows.copyHeightsTo (&*first);
+    rebuildTree();
+}
+
+/*  Writes the heights of all the stored rows. */
+void RowHeightIndex::copyHeightsTo (int* dest) const
+{
+    if (! compressed)
+    {
+        std::copy (heights.begin(), heights.end(), dest);
+        return;
+    }
+
+    runs.copyHeightsTo (dest);
+}
+
+/*  Drops the removed rows before firstRow from the storage. */
+void RowHeightIndex::compact()
+{
+    if (firstRow == 0)
+        return;
+
+    if (compressed)
+    {
+        runs.removeRows (0, firstRow);
+        firstRow = 0;
+        firstRowY = 0;
+        runsChanged();
+        decompressIfTooManyRuns();
+        return;
+    }
+
+    heights.erase (heights.begin(), heights.begin() + firstRow);
+    firstRow = 0;
+    firstRowY = 0;
+    rebuildTree();
+}
+
+void RowHeightIndex::rebuildTree()
+{
+    const auto n = getNumStoredRows();
+    tree.resize ((size_t) n + 1);
+    ++revision;
+
+    // First a plain running sum, so tree[k] is the bottom of row k - 1. Each step depends
+    // on the one before, so this isn't vectorised, but it's a single streaming pass that is
+    // limited by memory bandwidth rather than by the additions. Blocked scans that break up
+    // the dependency measured slower than this on 2M rows...
+    auto* t = tree.data();
+    const auto* h = heights.data();
+    t[0] = 0;
+
+    for (auto k = 1; k <= n; ++k)
+        t[k] = t[k - 1] + h[k - 1];
+
+    totalHeight = t[n];
+
+    // ...then each node becomes the difference of two prefix sums. The second one is read
+    // with a varying stride, so this isn't vectorised either. Going downwards means the
+    // lower prefix sum hasn't been overwritten yet.
+    for (auto k = n; k > 0; --k)
+        t[k] -= t[k - lowestBit (k)];
+
+    highestStep = n > 0 ? (int) juce::nextPowerOfTwo (n + 1) >> 1 : 0;
+}
+
+/*  Adds the tree nodes for rows appended after numStoredRowsBefore. Each node is its own
+    row plus the nodes that cover the rest of its range, which adds up to O(1) amortised.
+*/
+void RowHeightIndex::extendTree (const int numStoredRowsBefore)
+{
+    const auto n = getNumStoredRows();
+    tree.resize ((size_t) n + 1);
+    ++revision;
+
+    for (auto k = numStoredRowsBefore + 1; k <= n; ++k)
+    {
+        juce::int64 sum = heights[(size_t) k - 1];
+
+        for (auto j = k - 1; j > k - lowestBit (k); j -= lowestBit (j))
+            sum += tree[(size_t) j];
+
+        tree[(size_t) k] = sum;
+        totalHeight += heights[(size_t) k - 1];
+    }
+
+    highestStep = n > 0 ? (int) juce::nextPowerOfTwo (n + 1) >> 1 : 0;
+}
+
+//==============================================================================
+/*  Expands the runs into individual heights. The caller rebuilds the tree. */
+void RowHeightIndex::decompress()
+{
+    jassert (compressed);
+
+    heights.resize ((size_t) runs.getNumRows());
+    copyHeightsTo (heights.data());
+
+    compressed = false;
+    runs = {};
+}
+
+void RowHeightIndex::decompressIfTooManyRuns()
+{
+    if (compressed && ! shouldCompress ((size_t) runs.getNumRuns(), runs.getNumRows()))
+    {
+        decompress();
+        rebuildTree();
+    }
+}
+
+void RowHeightIndex::runsChanged()
+{
+    totalHeight = runs.getTotalHeight();
+    ++revision;
+}
+
+//==============================================================================
+void RowHeightIndex::RunTree::clear()
+{
+    nodes.clear();
+    freeNodes.clear();
+    root = none;
+    numRuns = 0;
+}
+
+RowHeightIndex::Run RowHeightIndex::RunTree::findRow (int row) const noexcept
+{
+    jassert (juce::isPositiveAndBelow (row, getNumRows()));
+
+    Run run { 0, 0, 0, 0 };
+
+    for (auto node = root;;)
+    {
+        const auto& n = nodes[(size_t) node];
+        const auto rowsOnLeft = getRows (n.left);
+
+        if (row < rowsOnLeft)
+        {
+            node = n.left;
+            continue;
+        }
+
+        run.firstRow += rowsOnLeft;
+        run.y += getSubtreeHeight (n.left);
+        row -= rowsOnLeft;
+
+        if (row < n.numRows)
+            return { run.firstRow, n.numRows, n.height, run.y };
+
+        run.firstRow += n.numRows;
+        run.y += (juce::int64) n.numRows * n.height;
+        row -= n.numRows;
+        node = n.right;
+    }
+}
+
+RowHeightIndex::Run RowHeightIndex::RunTree::findY (juce::int64 y) const noexcept
+{
+    jassert (y >= 0 && y < getTotalHeight());
+
+    Run run { 0, 0, 0, 0 };
+
+    for (auto node = root;;)
+    {
+        const auto& n = nodes[(size_t) node];
+        const auto heightOnLeft = getSubtreeHeight (n.left);
+
+        if (y < heightOnLeft)
+        {
+            node = n.left;
+            continue;
+        }
+
+        run.firstRow += getRows (n.left);
+        run.y += heightOnLeft;
+        y -= heightOnLeft;
+
+        const auto runHeight = (juce::int64) n.numRows * n.height;
+
+        if (y < runHeight)
+            return { run.firstRow, n.numRows, n.height, run.y };
+
+        run.firstRow += n.numRows;
+        run.y += runHeight;
+        y -= runHeight;
+        node = n.right;
+    }
+}
+
+void RowHeightIndex::RunTree::append (const int numRowsToAppend, const int height)
+{
+    root = join (root, createNode (numRowsToAppend, height));
+}
+
+void RowHeightIndex::RunTree::setHeight (const int row, const int height)
+{
+    // cut the row out as a run of its own, which join() merges with its neighbours again
+    const auto [before, rest] = split (root, row);
+    const auto [single, after] = split (rest, 1);
+
+    nodes[(size_t) single].height = height;
+    update (single);
+
+    root = join (join (before, single), after);
+}
+
+void RowHeightIndex::RunTree::removeRows (const int startRow, const int numRowsToRemove)
+{
+    const auto [before, rest] = split (root, startRow);
+    const auto [removed, after] = split (rest, numRowsToRemove);
+
+    freeTree (removed);
+    root = join (before, after);
+}
+
+void RowHeightIndex::RunTree::insertRows (const int startRow, const RunTree& newRuns)
+{
+    const auto [before, after] = split (root, startRow);
+    const auto inserted = copyRunsFrom (newRuns, newRuns.root, none);
+
+    root = join (join (before, inserted), after);
+}
+
+void RowHeightIndex::RunTree::moveRows (const int startRow, const int numRowsToMove, const int newStartRow)
+{
+    const auto [before, rest] = split (root, startRow);
+    const auto [moved, after] = split (rest, numRowsToMove);
+    const auto [newBefore, newAfter] = split (join (before, after), newStartRow);
+
+    root = join (join (newBefore, moved), newAfter);
+}
+
+int* RowHeightIndex::RunTree::copyHeightsTo (int* dest) const
+{
+    return copyHeightsTo (root, dest);
+}
+
+int RowHeightIndex::RunTree::createNode (const int numRowsInRun, const int height)
+{
+    // xorshift, which is plenty for balancing
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    const Node node { numRowsInRun, height, seed, none, none, numRowsInRun, (juce::int64) numRowsInRun * height };
+    ++numRuns;
+
+    if (freeNodes.empty())
+    {
+        nodes.push_back (node);
+        return (int) nodes.size() - 1;
+    }
+
+    const auto index = freeNodes.back();
+    freeNodes.pop_back();
+    nodes[(size_t) index] = node;
+    return index;
+}
+
+void RowHeightIndex::RunTree::freeTree (const int node)
+{
+    if (node == none)
+        return;
+
+    freeTree (nodes[(size_t) node].left);
+    freeTree (nodes[(size_t) node].right);
+    freeNodes.push_back (node);
+    --numRuns;
+}
+
+void RowHeightIndex::RunTree::update (const int node) noexcept
+{
+    auto& n = nodes[(size_t) node];
+    n.subtreeRows = getRows (n.left) + n.numRows + getRows (n.right);
+    n.subtreeHeight = getSubtreeHeight (n.left) + (juce::int64) n.numRows * n.height + getSubtreeHeight (n.right);
+}
+
+/*  Joins two trees, all of whose rows in left come before those in right. */
+int RowHeightIndex::RunTree::merge (const int left, const int right)
+{
+    if (left == none || right == none)
+        return left == none ? right : left;
+
+    if (nodes[(size_t) left].priority > nodes[(size_t) right].priority)
+    {
+        const auto newRight = merge (nodes[(size_t) left].right, right);
+        nodes[(size_t) left].right = newRight;
+        update (left);
+        return left;
+    }
+
+    const auto newLeft = merge (left, nodes[(size_t) right].left);
+    nodes[(size_t) right].left = newLeft;
+    update (right);
+    return right;
+}
+
+/*  Splits a tree into its first numRowsOnLeft rows and the rest, splitting a run in two if needed. */
+std::pair<int, int> RowHeightIndex::RunTree::split (const int node, const int numRowsOnLeft)
+{
+    if (node == none)
+        return { none, none };
+
+    const auto rowsOnLeft = getRows (nodes[(size_t) node].left);
+    const auto runEnd = rowsOnLeft + nodes[(size_t) node].numRows;
+
+    if (numRowsOnLeft <= rowsOnLeft)
+    {
+        const auto [left, right] = split (nodes[(size_t) node].left, numRowsOnLeft);
+        nodes[(size_t) node].left = right;
+        update (node);
+        return { left, node };
+    }
+
+    if (numRowsOnLeft >= runEnd)
+    {
+        const auto [left, right] = split (nodes[(size_t) node].right, numRowsOnLeft - runEnd);
+        nodes[(size_t) node].right = left;
+        update (node);
+        return { node, right };
+    }
+
+    // the split falls inside this run, so the rest of it becomes a new run on the right
+    const auto rest = createNode (runEnd - numRowsOnLeft, nodes[(size_t) node].height);
+    const auto right = nodes[(size_t) node].right;
+
+    nodes[(size_t) node].numRows = numRowsOnLeft - rowsOnLeft;
+    nodes[(size_t) node].right = none;
+    update (node);
+
+    return { node, merge (rest, right) };
+}
+
+/*  Like merge(), but joins the runs on either side of the seam if they have the same height. */
+int RowHeightIndex::RunTree::join (const int left, int right)
+{
+    if (left == none || right == none)
+        return left == none ? right : left;
+
+    auto last = left;
+
+    while (nodes[(size_t) last].right != none)
+        last = nodes[(size_t) last].right;
+
+    auto first = right;
+
+    while (nodes[(size_t) first].left != none)
+        first = nodes[(size_t) first].left;
+
+    if (nodes[(size_t) last].height == nodes[(size_t) first].height)
+    {
+        const auto [firstRun, rest] = split (right, nodes[(size_t) first].numRows);
+
+        addRowsToLastRun (left, nodes[(size_t) firstRun].numRows);
+        freeTree (firstRun);
+        right = rest;
+    }
+
+    return merge (left, right);
+}
+
+void RowHeightIndex::RunTree::addRowsToLastRun (const int node, const int numRowsToAdd)
+{
+    auto& n = nodes[(size_t) node];
+
+    if (n.right != none)
+        addRowsToLastRun (n.right, numRowsToAdd);
+    else
+        n.numRows += numRowsToAdd;
+
+    update (node);
+}
+
+/*  Appends copies of the runs in one of another tree's subtrees to a tree of this one. */
+int RowHeightIndex::RunTree::copyRunsFrom (const RunTree& other, const int otherNode, int tree)
+{
+    if (otherNode == none)
+        return tree;
+
+    const auto& n = other.nodes[(size_t) otherNode];
+
+    tree = copyRunsFrom (other, n.left, tree);
+    tree = join (tree, createNode (n.numRows, n.height));
+    return copyRunsFrom (other, n.right, tree);
+}
+
+int* RowHeightIndex::RunTree::copyHeightsTo (const int node, int* dest) const
+{
+    if (node == none)
+        return dest;
+
+    const auto& n = nodes[(size_t) node];
+
+    dest = copyHeightsTo (n.left, dest);
+    dest = std::fill_n (dest, n.numRows, n.height);
+    return copyHeightsTo (n.right, dest);
+}
+
+} // namespace jux
@@ -0,0 +1,304 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace jux
+{
+//==============================================================================
+/**
+    Keeps the heights of a list's rows and answers position queries on them.
+
+    Heights that come in long runs of the same value (e.g. a list where all rows
+    have the same height, or groups of fixed-height rows) are stored run-length
+    encoded, which takes O(runs) memory. The runs are kept in a balanced tree, so
+    converting a row to its y position, finding the row containing a y position and
+    changing a single row's height are O(log runs). A list of uniform height is a
+    single run, so buildUniform() is O(1).
+
+    Once there are too many runs for that to pay off, the index switches to a Fenwick
+    (binary indexed) tree of the individual heights, in which converting a row to its
+    y position, finding the row containing a y position and changing a single row's
+    height are all O(log N). The total height is cached in both cases. Every change to
+    the rows checks the number of runs, but the switch is one-way: only clear(), build()
+    and buildUniform() go back to run-length encoding.
+
+    Appending rows only touches the new ones, and removing rows from the start just
+    moves the index's first row along (the storage is compacted once more than half
+    of it is unused), so a list that grows at the end and drops its oldest rows, like
+    a log, costs O(1) amortised per row.
+
+    Positions are 64-bit, as a long enough list can be taller than an int can hold.
+
+    Heights must be positive.
+
+    @see ListBox
+*/
+class RowHeightIndex
+{
+public:
+    //==============================================================================
+    RowHeightIndex() = default;
+
+    /** Rebuilds the index for numRows rows. O(N).
+
+        fillHeights (juce::Range<int> rows, int* dest) is called for consecutive blocks
+        of rows and must write their heights into dest. Heights that aren't positive
+        are replaced with defaultHeight.
+    */
+    template <typename BlockFiller>
+    void build (int numRows, int defaultHeight, BlockFiller&& fillHeights)
+    {
+        clear();
+        appendInBlocks (numRows, defaultHeight, fillHeights);
+        finishBuilding();
+    }
+
+    /** Rebuilds the index for numRows rows that all have the same height. O(1). */
+    void buildUniform (int numRows, int height);
+
+    /** Removes all rows. */
+    void clear();
+
+    /** Inserts numRows rows before startRow, filling in their heights the same way as build().
+        This is O(N), or O(numRows + new runs * log runs) while the heights are run-length
+        encoded, and doesn't query the heights of the existing rows again.
+    */
+    template <typename BlockFiller>
+    void insertRows (int startRow, int numRows, int defaultHeight, BlockFiller&& fillHeights)
+    {
+        jassert (juce::isPositiveAndNotGreaterThan (startRow, size()) && numRows >= 0);
+
+        if (startRow == size())
+        {
+            appendRows (numRows, defaultHeight, fillHeights);
+            return;
+        }
+
+        RowHeightIndex newRows;
+        newRows.build (numRows, defaultHeight, [&] (juce::Range<int> rows, int* dest) { fillHeights (rows + startRow, dest); });
+        insert (startRow, newRows);
+    }
+
+    /** Adds numRows rows at the end, filling in their heights the same way as build().
+        This is O(numRows) amortised.
+    */
+    template <typename BlockFiller>
+    void appendRows (int numRows, int defaultHeight, BlockFiller&& fillHeights)
+    {
+        jassert (numRows >= 0);
+
+        const auto wasCompressed = compressed;
+        const auto numRowsBefore = getNumStoredRows();
+
+        appendInBlocks (numRows, defaultHeight, fillHeights);
+        finishAppending (wasCompressed, numRowsBefore);
+    }
+
+    /** Removes numRows rows starting at startRow. O(N), or O(log runs + removed runs) while
+        run-length encoded. Removing rows from the start is O(1) amortised, see removeFirstRows().
+    */
+    void removeRows (int startRow, int numRows);
+
+    /** Removes the first numRows rows. O(1) amortised. */
+    void removeFirstRows (int numRows);
+
+    /** Moves numRows rows starting at startRow so that the first of them ends up at
+        newStartRow (an index in the list after the move). O(N), or O(log runs) while
+        run-length encoded.
+    */
+    void moveRows (int startRow, int numRows, int newStartRow);
+
+    /** Returns the number of rows in the index. */
+    int size() const noexcept { return getNumStoredRows() - firstRow; }
+
+    /** Returns true if the heights are currently stored run-length encoded. */
+    bool isCompressed() const noexcept { return compressed; }
+
+    /** Returns the height of a row, which must be in range. */
+    int getHeight (int row) const noexcept;
+
+    /** Changes the height of a single row. O(log N) or O(log runs). */
+    void setHeight (int row, int newHeight);
+
+    /** Returns the y position of the top of a row. O(log N) or O(log runs).
+        The row can be equal to size(), in which case this returns the total height.
+    */
+    juce::int64 getRowY (int row) const noexcept;
+
+    /** Returns the y position of the bottom of a row. O(log N) or O(log runs). */
+    juce::int64 getRowBottom (int row) const noexcept { return getRowY (row) + getHeight (row); }
+
+    /** Finds the row that contains a y position. O(log N) or O(log runs).
+
+        Returns -1 if the position is above the first row and size() if it
+        is below the last one.
+    */
+    int getRowContaining (juce::int64 y) const noexcept;
+
+    /** Returns the sum of all the row heights. */
+    juce::int64 getTotalHeight() const noexcept { return totalHeight - firstRowY; }
+
+    /** Returns a number that changes whenever any row's height or position changes. */
+    juce::uint32 getRevision() const noexcept { return revision; }
+
+private:
+    //==============================================================================
+    static constexpr int blockSize = 4096;
+
+    // Beyond this many runs, walking the tree costs more than the memory saved is worth.
+    static constexpr int maxRuns = 16384;
+
+    /*  numRows rows of the same height, starting at firstRow and y. */
+    struct Run
+    {
+        int firstRow, numRows, height;
+        juce::int64 y;
+    };
+
+    /*  The runs, in a treap (a binary tree balanced by random priorities) ordered by row.
+        Each node also holds the number of rows and the total height of its subtree, so
+        finding a row or a y position is a walk down the tree, and rows are inserted,
+        removed and moved by splitting and joining trees. Neighbouring runs of the same
+        height are always joined into one.
+    */
+    class RunTree
+    {
+    public:
+        void clear();
+
+        int getNumRuns() const noexcept { return numRuns; }
+        int getNumRows() const noexcept { return getRows (root); }
+        juce::int64 getTotalHeight() const noexcept { return getSubtreeHeight (root); }
+
+        // the row and y must be inside the tree
+        Run findRow (int row) const noexcept;
+        Run findY (juce::int64 y) const noexcept;
+
+        void append (int numRows, int height);
+        void setHeight (int row, int height);
+        void removeRows (int startRow, int numRows);
+        void insertRows (int startRow, const RunTree& newRuns);
+        void moveRows (int startRow, int numRows, int newStartRow);
+
+        int* copyHeightsTo (int* dest) const;
+
+    private:
+        static constexpr int none = -1;
+
+        struct Node
+        {
+            int numRows, height;
+            juce::uint32 priority;
+            int left, right;
+            int subtreeRows;
+            juce::int64 subtreeHeight;
+        };
+
+        int getRows (int node) const noexcept { return node == none ? 0 : nodes[(size_t) node].subtreeRows; }
+        juce::int64 getSubtreeHeight (int node) const noexcept { return node == none ? 0 : nodes[(size_t) node].subtreeHeight; }
+
+        int createNode (int numRows, int height);
+        void freeTree (int node);
+        void update (int node) noexcept;
+        int merge (int left, int right);
+        std::pair<int, int> split (int node, int numRowsOnLeft);
+        int join (int left, int right);
+        void addRowsToLastRun (int node, int numRowsToAdd);
+        int copyRunsFrom (const RunTree& other, int otherNode, int tree);
+        int* copyHeightsTo (int node, int* dest) const;
+
+        std::vector<Node> nodes;
+        std::vector<int> freeNodes;
+        int root = none, numRuns = 0;
+        juce::uint32 seed = 0x9e3779b9;
+    };
+
+    template <typename BlockFiller>
+    void appendInBlocks (int numRows, int defaultHeight, BlockFiller& fillHeights)
+    {
+        const auto startRow = size();
+        const auto numStoredRowsAfter = getNumStoredRows() + numRows;
+        std::vector<int> block ((size_t) juce::jlimit (0, blockSize, numRows));
+
+        for (auto blockStart = 0; blockStart < numRows; blockStart += blockSize)
+        {
+            const juce::Range<int> rows (blockStart, juce::jmin (numRows, blockStart + blockSize));
+
+            fillHeights (rows + startRow, block.data());
+            replaceNonPositive (block.data(), rows.getLength(), defaultHeight);
+            appendHeights (block.data(), rows.getLength(), numStoredRowsAfter);
+        }
+    }
+
+    static void replaceNonPositive (int* dest, int num, int replacement) noexcept;
+    static bool shouldCompress (size_t numRuns, int numRows) noexcept;
+
+    // Everything below works on the stored rows, including the removed ones before firstRow.
+    int getNumStoredRows() const noexcept { return compressed ? runs.getNumRows() : (int) heights.size(); }
+    juce::int64 getStoredRowY (int storedRow) const noexcept;
+    int getStoredRowContaining (juce::int64 storedY) const noexcept;
+
+    void appendHeights (const int* src, int num, int expectedNumStoredRows);
+    void finishBuilding();
+    void finishAppending (bool wasCompressed, int numStoredRowsBefore);
+    void insert (int startRow, const RowHeightIndex& newRows);
+    void copyHeightsTo (int* dest) const;
+    void compact();
+
+    void rebuildTree();
+    void extendTree (int numStoredRowsBefore);
+
+    void decompress();
+    void decompressIfTooManyRuns();
+    void runsChanged();
+
+    bool compressed = true;
+
+    // rows before firstRow have been removed, but are still stored
+    int firstRow = 0;
+    juce::int64 firstRowY = 0;
+
+    // run-length encoded heights
+    RunTree runs;
+
+    // otherwise the individual heights and a tree of them, which is 1-based:
+    // tree[k] holds the sum of the rows in (k - lowestBit (k), k].
+    std::vector<int> heights;
+    std::vector<juce::int64> tree;
+    int highestStep = 0;
+
+    juce::int64 totalHeight = 0;
+    juce::uint32 revision = 0;
+
+    JUCE_LEAK_DETECTOR (RowHeightIndex)
+};
+
+} // namespace jux
@@ -0,0 +1,351 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "RowSelection.h"
+
+namespace jux
+{
+RowSelection::RowSelection (const juce::SparseSet<int>& rows)
+{
+    for (auto i = 0; i < rows.getNumRanges(); ++i)
+        addRange (rows.getRange (i));
+}
+
+RowSelection& RowSelection::operator= (const RowSelection& other)
+{
+    ranges = other.ranges;
+    numRows = other.numRows;
+    ++revision;
+    return *this;
+}
+
+RowSelection& RowSelection::operator= (RowSelection&& other) noexcept
+{
+    ranges = std::move (other.ranges);
+    numRows = other.numRows;
+    ++revision;
+    return *this;
+}
+
+juce::SparseSet<int> RowSelection::toSparseSet() const
+{
+    juce::SparseSet<int> result;
+
+    if (ranges.empty())
+        return result;
+
+    // SparseSet::addRange() re-sorts all of its ranges, but removeRange() works back from
+    // the last range. So this starts with the total range and cuts the gaps out of it
+    // in order, each of which only splits the last range.
+    result.addRange (getTotalRange());
+
+    for (auto iter = ranges.begin(), next = std::next (iter); next != ranges.end(); iter = next++)
+        result.removeRange ({ iter->second, next->first });
+
+    return result;
+}
+
+//==============================================================================
+void RowSelection::addRange (const juce::Range<int> rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    auto start = rows.getStart();
+    auto end = rows.getEnd();
+
+    // swallow every range that overlaps or touches the new one
+    auto iter = findFirstRangeEndingAfter (start - 1);
+
+    while (iter != ranges.end() && iter->first <= end)
+    {
+        start = juce::jmin (start, iter->first);
+        end = juce::jmax (end, iter->second);
+        numRows -= iter->second - iter->first;
+        iter = ranges.erase (iter);
+    }
+
+    ranges.emplace_hint (iter, start, end);
+    numRows += end - start;
+    ++revision;
+}
+
+void RowSelection::removeRange (const juce::Range<int> rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    auto iter = findFirstRangeEndingAfter (rows.getStart());
+
+    while (iter != ranges.end() && iter->first < rows.getEnd())
+    {
+        const auto start = iter->first;
+        const auto end = iter->second;
+
+        numRows -= end - start;
+        iter = ranges.erase (iter);
+
+        // put back whatever sticks out on either side
+        if (start < rows.getStart())
+        {
+            ranges.emplace_hint (iter, start, rows.getStart());
+            numRows += rows.getStart() - start;
+        }
+
+        if (end > rows.getEnd())
+        {
+            ranges.emplace_hint (iter, rows.getEnd(), end);
+            numRows += end - rows.getEnd();
+        }
+    }
+
+    ++revision;
+}
+
+void RowSelection::addRanges (const RowSelection& other)
+{
+    for (const auto& r : other.ranges)
+        addRange ({ r.first, r.second });
+}
+
+void RowSelection::clear()
+{
+    ranges.clear();
+    numRows = 0;
+    ++revision;
+}
+
+//==============================================================================
+bool RowSelection::contains (const int row) const noexcept
+{
+    const auto iter = findFirstRangeEndingAfter (row);
+    return iter != ranges.end() && iter->first <= row;
+}
+
+bool RowSelection::overlapsRange (const juce::Range<int> rows) const noexcept
+{
+    if (rows.isEmpty())
+        return false;
+
+    const auto iter = findFirstRangeEndingAfter (rows.getStart());
+    return iter != ranges.end() && iter->first < rows.getEnd();
+}
+
+int RowSelection::countInRange (const juce::Range<int> rows) const noexcept
+{
+    auto count = 0;
+
+    for (auto iter = findFirstRangeEndingAfter (rows.getStart()); iter != ranges.end() && iter->first < rows.getEnd(); ++iter)
+        count += juce::Range<int> (iter->first, iter->second).getIntersectionWith (rows).getLength();
+
+    return count;
+}
+
+int RowSelection::getNextRow (const int row) const noexcept
+{
+    const auto iter = findFirstRangeEndingAfter (row);
+
+    if (iter == ranges.end())
+        return -1;
+
+    return juce::jmax (row, iter->first);
+}
+
+RowSelection RowSelection::getRowsIn (const juce::Range<int> rows) const
+{
+    RowSelection result;
+
+    for (auto iter = findFirstRangeEndingAfter (rows.getStart()); iter != ranges.end() && iter->first < rows.getEnd(); ++iter)
+    {
+        const auto overlap = juce::Range<int> (iter->first, iter->second).getIntersectionWith (rows);
+        result.append (overlap.getStart(), overlap.getEnd());
+    }
+
+    return result;
+}
+
+RowSelection RowSelection::withoutRowsIn (const RowSelection& other) const
+{
+    RowSelection result;
+
+    if (ranges.empty())
+        return result;
+
+    auto cut = other.findFirstRangeEndingAfter (ranges.begin()->first);
+
+    for (const auto& r : ranges)
+    {
+        auto start = r.first;
+
+        while (cut != other.ranges.end() && cut->second <= start)
+            ++cut;
+
+        for (auto c = cut; c != other.ranges.end() && c->first < r.second && start < r.second; ++c)
+        {
+            if (c->first > start)
+                result.append (start, c->first);
+
+            start = juce::jmin (r.second, c->second);
+        }
+
+        if (start < r.second)
+            result.append (start, r.second);
+    }
+
+    return result;
+}
+
+int RowSelection::getRow (int index) const noexcept
+{
+    if (index < 0 || index >= numRows)
+        return -1;
+
+    for (const auto& r : ranges)
+    {
+        const auto length = r.second - r.first;
+
+        if (index < length)
+            return r.first + index;
+
+        index -= length;
+    }
+
+    jassertfalse;
+    return -1;
+}
+
+juce::Range<int> RowSelection::getTotalRange() const noexcept
+{
+    if (ranges.empty())
+        return {};
+
+    return { ranges.begin()->first, ranges.rbegin()->second };
+}
+
+//==============================================================================
+void RowSelection::insertRows (const int startRow, const int numRowsToInsert)
+{
+    if (numRowsToInsert <= 0 || ranges.empty() || ranges.rbegin()->second <= startRow)
+        return;
+
+    RowSelection result;
+
+    for (const auto& r : ranges)
+    {
+        if (r.second <= startRow)
+        {
+            result.append (r.first, r.second);
+        }
+        else if (r.first >= startRow)
+        {
+            result.append (r.first + numRowsToInsert, r.second + numRowsToInsert);
+        }
+        else
+        {
+            result.append (r.first, startRow);
+            result.append (startRow + numRowsToInsert, r.second + numRowsToInsert);
+        }
+    }
+
+    ranges = std::move (result.ranges);
+    numRows = result.numRows;
+    ++revision;
+}
+
+void RowSelection::removeRows (const int startRow, const int numRowsToRemove)
+{
+    if (numRowsToRemove <= 0)
+        return;
+
+    removeRange (juce::Range<int>::withStartAndLength (startRow, numRowsToRemove));
+
+    if (ranges.empty() || ranges.rbegin()->second <= startRow)
+        return;
+
+    RowSelection result;
+
+    for (const auto& r : ranges)
+    {
+        if (r.second <= startRow)
+            result.append (r.first, r.second);
+        else
+            result.append (r.first - numRowsToRemove, r.second - numRowsToRemove);
+    }
+
+    ranges = std::move (result.ranges);
+    numRows = result.numRows;
+    ++revision;
+}
+
+void RowSelection::moveRows (const int startRow, const int numRowsToMove, const int newStartRow)
+{
+    if (numRowsToMove <= 0 || startRow == newStartRow)
+        return;
+
+    const auto moved = getRowsIn (juce::Range<int>::withStartAndLength (startRow, numRowsToMove));
+
+    removeRows (startRow, numRowsToMove);
+    insertRows (newStartRow, numRowsToMove);
+
+    for (const auto& r : moved.ranges)
+        addRange (juce::Range<int> (r.first, r.second) + (newStartRow - startRow));
+}
+
+//==============================================================================
+RowSelection::RangeMap::const_iterator RowSelection::findFirstRangeEndingAfter (const int row) const noexcept
+{
+    // the range that starts at or before the row is the only one that can contain it
+    auto iter = ranges.upper_bound (row);
+
+    if (iter != ranges.begin() && std::prev (iter)->second > row)
+        return std::prev (iter);
+
+    return iter;
+}
+
+void RowSelection::append (const int start, const int end)
+{
+    // joins onto the last range if they touch, which keeps the ranges separate
+    if (start >= end)
+        return;
+
+    if (! ranges.empty() && ranges.rbegin()->second == start)
+    {
+        ranges.rbegin()->second = end;
+    }
+    else
+    {
+        jassert (ranges.empty() || ranges.rbegin()->second < start);
+        ranges.emplace_hint (ranges.end(), start, end);
+    }
+
+    numRows += end - start;
+    ++revision;
+}
+
+} // namespace jux
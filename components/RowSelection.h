@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+namespace jux
+{
+//==============================================================================
+/**
+    A set of rows, stored as sorted, non-overlapping ranges.
+
+    This does the same job as juce::SparseSet<int>, but keeps its ranges in a balanced
+    tree, so adding, removing and looking up rows are O(log R) in the number of ranges
+    (plus the number of ranges that get merged or split), however fragmented the set is.
+
+    @see ListBox::getSelection
+*/
+class RowSelection
+{
+public:
+    //==============================================================================
+    RowSelection() = default;
+    RowSelection (const RowSelection&) = default;
+    RowSelection (RowSelection&&) noexcept = default;
+
+    /** Assigning counts as a change, see getRevision(). */
+    RowSelection& operator= (const RowSelection& other);
+    RowSelection& operator= (RowSelection&& other) noexcept;
+
+    /** Creates a set containing the same rows as a juce::SparseSet. */
+    explicit RowSelection (const juce::SparseSet<int>& rows);
+
+    /** Returns the same rows as a juce::SparseSet. O(R). */
+    juce::SparseSet<int> toSparseSet() const;
+
+    //==============================================================================
+    /** Adds a range of rows. */
+    void addRange (juce::Range<int> rows);
+
+    /** Removes a range of rows. */
+    void removeRange (juce::Range<int> rows);
+
+    /** Adds all the rows of another set. */
+    void addRanges (const RowSelection& other);
+
+    /** Removes all rows. */
+    void clear();
+
+    //==============================================================================
+    /** Returns true if the row is in the set. O(log R). */
+    bool contains (int row) const noexcept;
+
+    /** Returns true if any of these rows is in the set. O(log R). */
+    bool overlapsRange (juce::Range<int> rows) const noexcept;
+
+    /** Returns how many of these rows are in the set. O(log R + the ranges it overlaps). */
+    int countInRange (juce::Range<int> rows) const noexcept;
+
+    /** Returns the first row in the set that is at or after the given row, or -1 if there's none. O(log R). */
+    int getNextRow (int row) const noexcept;
+
+    /** Returns the rows of the set that are within a range. O(log R + the ranges it overlaps). */
+    RowSelection getRowsIn (juce::Range<int> rows) const;
+
+    /** Returns the rows of this set that aren't in another one. */
+    RowSelection withoutRowsIn (const RowSelection& other) const;
+
+    /** Returns the total number of rows in the set. O(1). */
+    int size() const noexcept { return numRows; }
+
+    /** Returns true if the set has no rows. */
+    bool isEmpty() const noexcept { return ranges.empty(); }
+
+    /** Returns the row at an index in the sorted set, or -1 if the index is out of range.
+        This walks the ranges, except for the first row, which is O(1).
+    */
+    int getRow (int index) const noexcept;
+
+    /** Returns the number of separate ranges in the set. */
+    int getNumRanges() const noexcept { return (int) ranges.size(); }
+
+    /** Returns the range from the first row of the set to the end of its last one. */
+    juce::Range<int> getTotalRange() const noexcept;
+
+    /** Returns a number that changes whenever the set changes. */
+    juce::uint32 getRevision() const noexcept { return revision; }
+
+    bool operator== (const RowSelection& other) const noexcept { return ranges == other.ranges; }
+    bool operator!= (const RowSelection& other) const noexcept { return ranges != other.ranges; }
+
+    //==============================================================================
+    /** Shifts the rows for numRowsToInsert rows being inserted before startRow. O(R). */
+    void insertRows (int startRow, int numRowsToInsert);
+
+    /** Drops the rows in a removed block and shifts the ones after it. O(R). */
+    void removeRows (int startRow, int numRowsToRemove);
+
+    /** Follows numRowsToMove rows starting at startRow being moved to newStartRow
+        (an index in the list after the move). O(R).
+    */
+    void moveRows (int startRow, int numRowsToMove, int newStartRow);
+
+    //==============================================================================
+    /** Iterates the ranges of the set in order. */
+    class Iterator
+    {
+    public:
+        explicit Iterator (std::map<int, int>::const_iterator i) noexcept : iter (i) {}
+
+        juce::Range<int> operator*() const noexcept { return { iter->first, iter->second }; }
+        Iterator& operator++() noexcept { ++iter; return *this; }
+
+        bool operator== (const Iterator& other) const noexcept { return iter == other.iter; }
+        bool operator!= (const Iterator& other) const noexcept { return iter != other.iter; }
+
+    private:
+        std::map<int, int>::const_iterator iter;
+    };
+
+    Iterator begin() const noexcept { return Iterator (ranges.begin()); }
+    Iterator end() const noexcept { return Iterator (ranges.end()); }
+
+private:
+    //==============================================================================
+    using RangeMap = std::map<int, int>;
+
+    RangeMap::const_iterator findFirstRangeEndingAfter (int row) const noexcept;
+    void append (int start, int end);
+
+    // start -> end, with no two ranges overlapping or touching
+    RangeMap ranges;
+    int numRows = 0;
+    juce::uint32 revision = 0;
+
+    JUCE_LEAK_DETECTOR (RowSelection)
+};
+
+} // namespace jux
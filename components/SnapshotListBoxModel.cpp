@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#include "SnapshotListBoxModel.h"
+
+namespace jux
+{
+SnapshotListBoxModel::~SnapshotListBoxModel()
+{
+    delete pending.exchange (nullptr);
+}
+
+void SnapshotListBoxModel::publish (std::unique_ptr<Snapshot> newSnapshot)
+{
+    jassert (newSnapshot != nullptr);
+    jassert (newSnapshot->rowHeights.empty() || (int) newSnapshot->rowHeights.size() == newSnapshot->numRows);
+
+    newSnapshot->sequenceNumber = ++lastSequenceNumber;
+
+    // a snapshot the list never picked up is deleted here, on the publishing thread
+    delete pending.exchange (newSnapshot.release());
+}
+
+int SnapshotListBoxModel::getNumRows()
+{
+    return current != nullptr ? current->numRows : 0;
+}
+
+int SnapshotListBoxModel::getRowHeight (const int rowNumber) const
+{
+    if (current == nullptr)
+        return -1;
+
+    if (current->rowHeights.empty())
+        return current->uniformRowHeight;
+
+    return juce::isPositiveAndBelow (rowNumber, current->numRows) ? current->rowHeights[(size_t) rowNumber] : -1;
+}
+
+bool SnapshotListBoxModel::getRowHeights (const juce::Range<int> rows, int* heights) const
+{
+    if (current == nullptr)
+        return false;
+
+    if (current->rowHeights.empty())
+        std::fill_n (heights, rows.getLength(), current->uniformRowHeight);
+    else
+        std::copy_n (current->rowHeights.data() + rows.getStart(), rows.getLength(), heights);
+
+    return true;
+}
+
+bool SnapshotListBoxModel::hasUniformRowHeights() const
+{
+    return current == nullptr || current->rowHeights.empty();
+}
+
+void SnapshotListBoxModel::listBoxFrameUpdate (ListBox& listBox)
+{
+    std::unique_ptr<Snapshot> next (pending.exchange (nullptr));
+
+    if (next == nullptr)
+        return;
+
+    const auto followsCurrent = current != nullptr && next->sequenceNumber == current->sequenceNumber + 1;
+    const auto change = followsCurrent ? next->changeType : Snapshot::ChangeType::unknown;
+    const auto rows = next->changedRows;
+
+    // the previous snapshot is deleted at the end of this function, after the list has moved on
+    std::swap (current, next);
+
+    switch (change)
+    {
+        case Snapshot::ChangeType::rowsInserted: listBox.rowsInserted (rows.getStart(), rows.getLength()); break;
+        case Snapshot::ChangeType::rowsRemoved:  listBox.rowsRemoved (rows.getStart(), rows.getLength()); break;
+        case Snapshot::ChangeType::rowsChanged:  listBox.rowsChanged (rows); break;
+        case Snapshot::ChangeType::unknown:      listBox.updateContent(); break;
+    }
+}
+
+} // namespace jux
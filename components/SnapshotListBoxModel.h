@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    MIT License
+
+    Copyright (c) 2020-2025 Tal Aviram
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "ListBox.h"
+
+namespace jux
+{
+//==============================================================================
+/**
+    A ListBoxModel whose data is built on other threads as immutable snapshots.
+
+    A worker thread fills in a Snapshot (usually a subclass of it that also holds
+    the row data) and hands it over with publish(). The list picks up the newest
+    published snapshot on its next display frame and relayouts once for it. The
+    message thread only ever reads the snapshot it's showing, so neither side
+    has to lock anything while the list is painted or scrolled.
+
+    Subclasses implement paintListBoxItem() and friends using getSnapshot().
+
+    A model should only be shown by one ListBox, and publish() should only be
+    called from one thread at a time.
+
+    @see ListBox, ListBoxModel::listBoxFrameUpdate
+*/
+class SnapshotListBoxModel : public ListBoxModel
+{
+public:
+    //==============================================================================
+    /** The rows of the list at one point in time. Don't change it once published. */
+    struct Snapshot
+    {
+        virtual ~Snapshot() = default;
+
+        /** The number of rows. */
+        int numRows = 0;
+
+        /** The height of each row, or empty if every row is uniformRowHeight high.
+            Heights that aren't positive are replaced with the list's default height.
+        */
+        std::vector<int> rowHeights;
+
+        /** The height of all rows if rowHeights is empty, or 0 for the list's default height. */
+        int uniformRowHeight = 0;
+
+        /** How this snapshot differs from the one published just before it. */
+        enum class ChangeType
+        {
+            unknown,      /**< The list updates all of its content. */
+            rowsInserted, /**< changedRows were inserted. */
+            rowsRemoved,  /**< changedRows (in the previous snapshot) were removed. */
+            rowsChanged   /**< The content of changedRows changed. */
+        };
+
+        /** If the list missed the previous snapshot, it updates all of its content anyway. */
+        ChangeType changeType = ChangeType::unknown;
+        juce::Range<int> changedRows;
+
+    private:
+        friend class SnapshotListBoxModel;
+        juce::uint64 sequenceNumber = 0;
+    };
+
+    //==============================================================================
+    SnapshotListBoxModel() = default;
+    ~SnapshotListBoxModel() override;
+
+    /** Hands a new snapshot over to the list. This can be called from any thread.
+
+        If the list hasn't picked up the previously published snapshot yet, that one
+        is dropped, and the list updates all of its content for this one.
+    */
+    void publish (std::unique_ptr<Snapshot> newSnapshot);
+
+    /** Returns the snapshot that the list is showing, or nullptr before the first one
+        has been picked up. Only call this on the message thread.
+    */
+    const Snapshot* getSnapshot() const noexcept { return current.get(); }
+
+    //==============================================================================
+    int getNumRows() override;
+    int getRowHeight (int rowNumber) const override;
+    bool getRowHeights (juce::Range<int> rows, int* heights) const override;
+    bool hasUniformRowHeights() const override;
+    void listBoxFrameUpdate (ListBox& listBox) override;
+
+private:
+    //==============================================================================
+    std::unique_ptr<Snapshot> current;
+    std::atomic<Snapshot*> pending { nullptr };
+    std::atomic<juce::uint64> lastSequenceNumber { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SnapshotListBoxModel)
+};
+
+} // namespace jux